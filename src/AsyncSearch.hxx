@@ -0,0 +1,102 @@
+#pragma once
+
+#include <thread>
+#include <stop_token>
+#include <atomic>
+#include <optional>
+#include <memory>
+#include <cstdint>
+
+#include "Board.hxx"
+#include "TranspositionTable.hxx"
+#include "Tablebase.hxx"
+
+
+// Board::bestMove on a worker thread, so whoever's waiting for it (the window) doesn't have to.
+// The worker searches its own copy of the board. All searches share one table, so pondering on the
+// opponent's time leaves the real search plenty already looked at
+class AsyncSearch {
+    std::shared_ptr<TranspositionTable> table = std::make_shared<TranspositionTable>();
+    std::shared_ptr<const Tablebase> tablebase;
+
+    std::jthread worker;
+    std::atomic<bool> finished = false;
+
+    // only touched by the worker until `finished` is set
+    Move result;
+    size_t result_nodes{};
+    int result_depth{};
+
+    // what the current (or last) search is about
+    std::uint64_t position{};
+    bool pondering = false;
+
+public:
+    // long enough to never be the reason a ponder stops. It stops when the opponent moves
+    constexpr static SearchLimits PONDER_LIMITS{.time = std::chrono::hours{1}};
+
+
+    AsyncSearch() = default;
+    AsyncSearch(const AsyncSearch&) = delete;
+    AsyncSearch& operator=(const AsyncSearch&) = delete;
+
+    ~AsyncSearch() { cancel(); }
+
+
+    // for every search started after this
+    void setTablebase(std::shared_ptr<const Tablebase> new_tablebase) noexcept { tablebase = std::move(new_tablebase); }
+
+
+    // stops whatever was running, then starts looking for the best move in `board`
+    void start(const Board& board, const SearchLimits limits) { launch(board, limits, false); }
+
+    // thinks about `board` for as long as it's left alone, just to fill the table. It never has a result
+    void ponder(const Board& board) { launch(board, PONDER_LIMITS, true); }
+
+    // waits for the worker to notice, a few milliseconds at most. Whatever it was doing gets thrown away
+    void cancel() {
+        if (not worker.joinable()) return;
+
+        worker.request_stop();
+        worker.join();
+    }
+
+
+    // the move, once the search finished. Never anything while pondering
+    std::optional<Move> poll() const noexcept {
+        if (pondering or not finished.load(std::memory_order_acquire)) return std::nullopt;
+        return result;
+    }
+
+    bool running() const noexcept { return worker.joinable() and not finished.load(std::memory_order_acquire); }
+
+    // whether the current (or finished) search is about this exact position
+    bool searching(const Board& board) const noexcept { return worker.joinable() and not pondering and position == board.getHash(); }
+    bool ponderingOn(const Board& board) const noexcept { return worker.joinable() and pondering and position == board.getHash(); }
+
+    // stats of the finished search
+    size_t nodes() const noexcept { return result_nodes; }
+    int depth() const noexcept { return result_depth; }
+
+
+private:
+    void launch(const Board& board, const SearchLimits limits, const bool ponder) {
+        cancel();
+
+        finished.store(false, std::memory_order_relaxed);
+        position  = board.getHash();
+        pondering = ponder;
+
+        Board copy = board;
+        copy.setTable(table);
+        if (tablebase) copy.setTablebase(tablebase);
+
+        worker = std::jthread{[this, copy, limits] (const std::stop_token stop) mutable {
+            result = copy.bestMove(limits, stop);
+            result_nodes = copy.nodes;
+            result_depth = copy.searched_depth;
+
+            finished.store(true, std::memory_order_release);
+        }};
+    }
+};
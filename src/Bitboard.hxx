@@ -0,0 +1,72 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+
+#include "Position.hxx"
+
+
+// one bit per square, square = y * 8 + x. So bit 0 is the top left corner and bit 63 the bottom right
+using Bitboard = std::uint64_t;
+
+
+// same order as the rays in DISTANCE_POSITIONS, so (direction + 2) % 4 is the opposite direction
+enum Direction : size_t { NORTH, EAST, SOUTH, WEST };
+
+
+constexpr Bitboard FILE_A = 0x0101010101010101;
+constexpr Bitboard FILE_H = FILE_A << 7;
+constexpr Bitboard ROW_0  = 0xFF;
+constexpr Bitboard ROW_7  = ROW_0 << 56;
+
+constexpr Bitboard PROMOTION_ROWS = ROW_0 | ROW_7;
+
+
+constexpr int squareOf(const Position pos) noexcept { return pos.y * 8 + pos.x; }
+constexpr Position positionOf(const int square) noexcept { return {square % 8, square / 8}; }
+
+constexpr Bitboard squareBit(const int square) noexcept { return Bitboard{1} << square; }
+constexpr Bitboard squareBit(const Position pos) noexcept { return squareBit(squareOf(pos)); }
+
+constexpr Bitboard rowBits(const int y) noexcept { return ROW_0 << (8 * y); }
+
+constexpr int popCount(const Bitboard bits) noexcept { return std::popcount(bits); }
+
+
+constexpr Direction opposite(const Direction direction) noexcept { return Direction((direction + 2) % 4); }
+
+// north and west go toward the lower squares, east and south toward the higher ones
+constexpr bool isIncreasing(const Direction direction) noexcept { return direction == EAST or direction == SOUTH; }
+
+// nearest set square when walking from some square in `direction`. Assumes bits != 0
+constexpr int nearestSquare(const Bitboard bits, const Direction direction) noexcept {
+    return isIncreasing(direction) ? std::countr_zero(bits) : 63 - std::countl_zero(bits);
+}
+
+// removes and returns the nearest square. Assumes bits != 0
+constexpr int popNearest(Bitboard& bits, const Direction direction) noexcept {
+    const auto square = nearestSquare(bits, direction);
+    bits ^= squareBit(square);
+    return square;
+}
+
+// removes and returns the lowest square, which is also the order the board is read in. Assumes bits != 0
+constexpr int popFirst(Bitboard& bits) noexcept {
+    const auto square = std::countr_zero(bits);
+    bits &= bits - 1;
+    return square;
+}
+
+
+// moves every bit one square in `direction`, dropping whatever falls off the board
+constexpr Bitboard shift(const Bitboard bits, const Direction direction) noexcept {
+    switch (direction) {
+        case NORTH: return  bits >> 8;
+        case EAST:  return (bits << 1) & ~FILE_A;
+        case SOUTH: return  bits << 8;
+        case WEST:  return (bits >> 1) & ~FILE_H;
+    }
+
+    return 0;
+}
@@ -0,0 +1,917 @@
+#pragma once
+
+#include <iostream>
+#include <cmath>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <limits>
+#include <ranges>
+#include <utility>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <stop_token>
+#include <optional>
+#include <cstdint>
+#include <cstdlib>
+
+
+#include "Piece.hxx"
+#include "Move.hxx"
+#include "Bitboard.hxx"
+#include "Zobrist.hxx"
+#include "TranspositionTable.hxx"
+#include "Tablebase.hxx"
+#include "helper.hxx"
+
+
+constexpr auto INF = 100000;
+
+constexpr auto MAX_SEARCH_DEPTH = 64;
+
+
+// bestMove deepens one ply at a time until either of these runs out
+struct SearchLimits {
+    int depth = MAX_SEARCH_DEPTH;
+    std::chrono::milliseconds time = std::chrono::seconds{1};
+    int threads = 1;
+};
+
+
+// for some reason can't put this as a method
+consteval auto precomputeDistancePositions() {
+    std::array<std::array<std::array<static_vector<Position, 8>, 4>, 8>, 8> data{};
+
+    for(const auto i : range(8uz)){
+        for(const auto j : range(8uz)){
+            const auto num_north = i;
+            const auto num_east  = 8 - j - 1;
+            const auto num_south = 8 - i - 1;
+            const auto num_west  = j;
+
+            for (const auto e : range(1, num_north +1)) data[i][j][0].push_back({ 0, -e});
+            for (const auto e : range(1, num_east  +1)) data[i][j][1].push_back({ e,  0});
+            for (const auto e : range(1, num_south +1)) data[i][j][2].push_back({ 0,  e});
+            for (const auto e : range(1, num_west  +1)) data[i][j][3].push_back({-e,  0});
+
+            // data[i][j] = {num_north, num_east, num_south, num_west};
+        }
+    }
+
+    return data;
+}
+
+constexpr inline auto DISTANCE_POSITIONS = precomputeDistancePositions();
+
+// DISTANCE_POSITIONS as masks, indexed by square then direction
+consteval auto precomputeDistanceRays() {
+    std::array<std::array<Bitboard, 4>, 64> data{};
+
+    for (const auto y : range(8)) {
+        for (const auto x : range(8)) {
+            for (const auto direction : range(4uz)) {
+                for (const auto distance : DISTANCE_POSITIONS[size_t(y)][size_t(x)][direction])
+                    data[size_t(squareOf({x, y}))][direction] |= squareBit(Position{x, y} + distance);
+            }
+        }
+    }
+
+    return data;
+}
+
+constexpr inline auto DISTANCE_RAYS = precomputeDistanceRays();
+
+constexpr inline std::array<std::pair<int, int>, 8> PROMOTION_DISTANCE = {{
+    {0  , 120},
+    {0  , 90 },
+    {0  , 60 },
+    {0  , 30 },
+    {30 , 0  },
+    {60 , 0  },
+    {90 , 0  },
+    {120, 0  }
+}};
+
+
+// what evaluate() counts. The defaults are what the game plays with, dama_match tries others against them
+struct EvalWeights {
+    int pawn   = Piece{Piece::Flags::ACTIVE}.value();
+    int shaikh = Piece{Piece::Flags::ACTIVE | Piece::Flags::SHAIKH}.value();
+    std::array<std::pair<int, int>, 8> promotion_distance = PROMOTION_DISTANCE;
+};
+
+
+
+// rules, move generation and search. Nothing in here draws or plays sounds, that's BoardState's job
+class Board {
+public:
+    constexpr static std::string_view STARTING_FEN = "8/bbbbbbbb/bbbbbbbb/8/8/yyyyyyyy/yyyyyyyy/8";
+
+    // whoever is true, goes first
+    constexpr static auto YELLOW_TURN = true;
+    constexpr static auto BLACK_TURN  = not YELLOW_TURN;
+
+protected:
+    constexpr static auto YELLOW_FORWARD = YELLOW_TURN ? NORTH : SOUTH; // yellow goes up, which is toward row 0
+    constexpr static auto BLACK_FORWARD  = opposite(YELLOW_FORWARD);
+    constexpr static auto RIGHT = EAST;
+    constexpr static auto LEFT  = WEST;
+
+    // shaikh captures can go any direction but back where they came from. This is "any direction"
+    constexpr static size_t NO_DIRECTION = 4;
+
+    EvalWeights weights;
+
+    // a square is empty if it's in neither color
+    Bitboard yellow_bits{};
+    Bitboard  black_bits{};
+    Bitboard shaikh_bits{};
+
+    // kept up to date by set/reset/promote and nextTurn
+    std::uint64_t hash{};
+
+    // evaluate() before the perspective flip, black's total minus yellow's. Kept up to date by set/reset/promote
+    int score{};
+
+public:
+    bool turn = YELLOW_TURN;
+
+    // nodes visited and depth finished by the last search
+    size_t nodes{};
+    int searched_depth{};
+    int searched_score{}; // for the side to move, as of searched_depth
+
+protected:
+    std::vector<Move> possible_moves;
+
+    // every ply's moves while searching, each ply's on top of its parent's. Reserved once, so searching doesn't allocate
+    std::vector<CompactMove> move_stack;
+    constexpr static size_t MOVE_STACK_SIZE = MAX_SEARCH_DEPTH * 128;
+
+    // shared between copies, so whatever one copy searched the others get for free
+    std::shared_ptr<TranspositionTable> table;
+    std::shared_ptr<const Tablebase> tablebase; // optional, searches just don't get the shortcut without it
+    std::chrono::steady_clock::time_point deadline;
+    std::stop_token stop_request;
+    size_t next_clock_check{};
+    bool stopped = false;
+
+public:
+    explicit Board(const std::string_view fen = STARTING_FEN, bool yellow_starts = true) noexcept
+    : turn{yellow_starts}
+    {
+        parseFen(fen);
+        generateMoves();
+    }
+
+    explicit Board(bool yellow_starts) noexcept
+    : turn{yellow_starts}
+    {
+        parseFen(STARTING_FEN);
+        generateMoves();
+    }
+
+    size_t yellowCount() const noexcept { return size_t(popCount(yellow_bits)); }
+    size_t  blackCount() const noexcept { return size_t(popCount( black_bits)); }
+
+    bool done() const noexcept { return yellowCount() == 0 or blackCount() == 0; }
+
+
+    bool yellowTurn() const noexcept { return turn == YELLOW_TURN; }
+    bool blackTurn()  const noexcept { return turn == BLACK_TURN;  }
+    void nextTurn() noexcept { turn =! turn; hash ^= ZOBRIST.black_turn; checkIncremental(); }
+    auto currentForward() const noexcept { return yellowTurn() ? YELLOW_FORWARD : BLACK_FORWARD; }
+    Bitboard      ownBits() const noexcept { return yellowTurn() ? yellow_bits : black_bits; }
+    Bitboard opponentBits() const noexcept { return yellowTurn() ? black_bits : yellow_bits; }
+
+
+    Piece get(const Position pos) const noexcept {
+        const auto bit = squareBit(pos);
+        if (not ((yellow_bits | black_bits) & bit)) return {};
+
+        auto flags = Piece::Flags::ACTIVE;
+        if (yellow_bits & bit) flags = flags | Piece::Flags::YELLOW;
+        if (shaikh_bits & bit) flags = flags | Piece::Flags::SHAIKH;
+        return flags;
+    }
+
+    void set(const Position pos, const Piece piece) noexcept {
+        reset(pos);
+        if (not piece.isActive()) return;
+
+        const auto bit = squareBit(pos);
+        (piece.isYellow() ? yellow_bits : black_bits) |= bit;
+        if (piece.isShaikh()) shaikh_bits |= bit;
+
+        hash ^= zobristKey(piece, squareOf(pos));
+        score += pieceScore(piece, pos);
+    }
+
+    void reset(const Position pos) noexcept {
+        if (const auto piece = get(pos)) {
+            hash ^= zobristKey(piece, squareOf(pos));
+            score -= pieceScore(piece, pos);
+        }
+
+        const auto bit = ~squareBit(pos);
+        yellow_bits &= bit;
+        black_bits  &= bit;
+        shaikh_bits &= bit;
+    }
+
+    void promote(const Position pos) noexcept {
+        if (const auto piece = get(pos); piece and piece.isPawn()) {
+            hash ^= zobristKey(piece, squareOf(pos)) ^ zobristKey(piece | Piece::Flags::SHAIKH, squareOf(pos));
+            score += pieceScore(piece | Piece::Flags::SHAIKH, pos) - pieceScore(piece, pos);
+        }
+
+        shaikh_bits |= squareBit(pos);
+    }
+
+
+    std::uint64_t getHash() const noexcept { return hash; }
+
+    void setTable(std::shared_ptr<TranspositionTable> new_table) noexcept { table = std::move(new_table); }
+    void setTablebase(std::shared_ptr<const Tablebase> new_tablebase) noexcept { tablebase = std::move(new_tablebase); }
+    void setWeights(const EvalWeights& new_weights) noexcept { weights = new_weights; score = computeScore(); }
+
+    // the exact score for the side to move, if few enough pieces are left for the tablebase to know it
+    std::optional<int> probeTablebase() const noexcept {
+        if (not tablebase) return std::nullopt;
+        return tablebase->probe(yellow_bits, black_bits, shaikh_bits, yellowTurn());
+    }
+
+    // from scratch, what set/reset/promote and nextTurn keep up incrementally
+    std::uint64_t computeHash() const noexcept {
+        std::uint64_t full = blackTurn() ? ZOBRIST.black_turn : 0;
+
+        for (auto pieces = yellow_bits | black_bits; pieces;) {
+            const auto square = popFirst(pieces);
+            full ^= zobristKey(get(positionOf(square)), square);
+        }
+
+        return full;
+    }
+
+    // what one piece adds to score. Only pawns get the promotion bonus, don't want shaikhs to be tempted to go up
+    int pieceScore(const Piece piece, const Position pos) const noexcept {
+        if (piece.isShaikh()) return piece.isYellow() ? -weights.shaikh : weights.shaikh;
+
+        const auto [black_bias, yellow_bias] = weights.promotion_distance[size_t(pos.y)];
+        return piece.isYellow() ? -(weights.pawn + yellow_bias) : weights.pawn + black_bias;
+    }
+
+    // from scratch, what set/reset/promote keep up incrementally
+    int computeScore() const noexcept {
+        const auto yellow_pawns = yellow_bits & ~shaikh_bits;
+        const auto  black_pawns =  black_bits & ~shaikh_bits;
+
+        int yellow_total = weights.pawn * popCount(yellow_pawns) + weights.shaikh * popCount(yellow_bits & shaikh_bits);
+        int  black_total = weights.pawn * popCount( black_pawns) + weights.shaikh * popCount( black_bits & shaikh_bits);
+
+        for (const auto y : range(8)) {
+            const auto b_dist_bias = weights.promotion_distance[size_t(y)].first ; // first  is black
+            const auto y_dist_bias = weights.promotion_distance[size_t(y)].second; // second is yellow
+
+            yellow_total += y_dist_bias * popCount(yellow_pawns & rowBits(y));
+             black_total += b_dist_bias * popCount( black_pawns & rowBits(y));
+        }
+
+        return black_total - yellow_total;
+    }
+
+    // after the bitboards were written directly instead of through set/reset/promote
+    void recomputeIncremental() noexcept {
+        hash  = computeHash();
+        score = computeScore();
+    }
+
+    // configure with -DDAMA_CHECK_INCREMENTAL=ON to have every turn checked against a full recomputation. Slow
+    void checkIncremental() const noexcept {
+    #ifdef DAMA_CHECK_INCREMENTAL
+        if (hash == computeHash() and score == computeScore()) return;
+
+        std::cerr << "incremental state is off at " << fen() << ": hash " << hash << " should be " << computeHash()
+                  << ", score " << score << " should be " << computeScore() << '\n';
+        std::abort();
+    #endif
+    }
+
+
+    constexpr static bool isValidPosition(const Position pos) noexcept {
+        return pos.x >= 0 and pos.x < 8 and pos.y >= 0 and pos.y <8;
+    }
+
+
+    // squares reachable from `square` walking in `direction` before running into any piece
+    static Bitboard openRay(const int square, const Direction direction, const Bitboard occupied) noexcept {
+        const auto ray = DISTANCE_RAYS[size_t(square)][direction];
+        const auto blockers = ray & occupied;
+        if (not blockers) return ray;
+
+        const auto blocker = nearestSquare(blockers, direction);
+        return ray ^ DISTANCE_RAYS[size_t(blocker)][direction] ^ squareBit(blocker);
+    }
+
+
+    // whether the side to move has to capture this turn. Cheaper than generating the captures
+    bool hasCaptures() const noexcept {
+        const auto own      = ownBits();
+        const auto opponent = opponentBits();
+        const auto occupied = own | opponent;
+
+        // pawns on the last row can't capture anymore
+        const auto pawns = own & ~shaikh_bits & ~PROMOTION_ROWS;
+        for (const auto direction : {currentForward(), RIGHT, LEFT}) {
+            // squares with an opponent piece right in front of an empty square, stepped back once more to where the pawn has to be
+            const auto jumpers = shift(shift(~occupied, opposite(direction)) & opponent, opposite(direction));
+            if (pawns & jumpers) return true;
+        }
+
+        for (auto shaikhs = own & shaikh_bits; shaikhs;) {
+            const auto square = popFirst(shaikhs);
+
+            for (const auto direction : {NORTH, EAST, SOUTH, WEST}) {
+                const auto blockers = DISTANCE_RAYS[size_t(square)][direction] & occupied;
+                if (not blockers) continue;
+
+                const auto capture_square = nearestSquare(blockers, direction);
+                if (squareBit(capture_square) & opponent and openRay(capture_square, direction, occupied)) return true;
+            }
+        }
+
+        return false;
+    }
+
+
+    // the generators below work for both kinds of moves. Move keeps the whole path for the UI, CompactMove only
+    // where it started, where it ended and what it took, which is all the search needs
+    static void startChain(Move& move, const int square) { move.positions.push_back(positionOf(square)); }
+    static void   endChain(Move& move)                   { move.positions.pop_back(); }
+
+    void addCapture(Move& move, const int landing_square, const int capture_square) const {
+        move.positions.push_back(positionOf(landing_square));
+        move.captures .push_back({get(positionOf(capture_square)), positionOf(capture_square)});
+    }
+
+    static void removeCapture(Move& move, int) noexcept {
+        move.positions.pop_back();
+        move.captures .pop_back();
+    }
+
+    static void addChain(std::vector<Move>& moves, const Move& move, int) { moves.push_back(move); }
+
+    static void addStep(std::vector<Move>& moves, const int from, const int to) { moves.push_back({{positionOf(from), positionOf(to)}}); }
+
+
+    static void startChain(CompactMove& move, const int square) noexcept { move = {static_cast<std::uint8_t>(square)}; }
+    static void   endChain(CompactMove&) noexcept {}
+
+    static void addCapture(CompactMove& move, int, const int capture_square) noexcept { move.captures |= squareBit(capture_square); }
+    static void removeCapture(CompactMove& move, const int capture_square) noexcept { move.captures ^= squareBit(capture_square); }
+
+    static void addChain(std::vector<CompactMove>& moves, CompactMove move, const int square) {
+        move.to = static_cast<std::uint8_t>(square);
+        moves.push_back(move);
+    }
+
+    static void addStep(std::vector<CompactMove>& moves, const int from, const int to) {
+        moves.push_back({static_cast<std::uint8_t>(from), static_cast<std::uint8_t>(to)});
+    }
+
+
+    // walks every capture chain depth first. `move` holds the chain so far, and only chains that can't go any further are added.
+    // `own` and `opponent` are the board as it looks mid chain. Captured pieces are gone right away and the pawn sits at `square`
+    template <typename MoveType>
+    void generatePawnCaptureMoves(std::vector<MoveType>& moves, MoveType& move, const int square, const Bitboard own, const Bitboard opponent) {
+        bool continued = false;
+
+        // a pawn that reaches the last row stops there
+        if (not (squareBit(square) & PROMOTION_ROWS)) {
+            for (const auto direction : {currentForward(), RIGHT, LEFT}) {
+                const auto capture_bit = shift(squareBit(square), direction);
+                const auto landing_bit = shift(capture_bit, direction);
+
+                if (
+                       not (capture_bit & opponent)            // not capturing an opponent's piece
+                    or not (landing_bit & ~(own | opponent))   // landing outside the board or at an occupied position
+                ) continue;
+
+
+                const auto capture_square = std::countr_zero(capture_bit);
+                const auto landing_square = std::countr_zero(landing_bit);
+
+                addCapture(move, landing_square, capture_square);
+
+                generatePawnCaptureMoves(moves, move, landing_square, own ^ squareBit(square) ^ landing_bit, opponent ^ capture_bit);
+
+                removeCapture(move, capture_square);
+
+                continued = true;
+            }
+        }
+
+        if (not continued and move.doesCapture()) addChain(moves, move, square);
+    }
+
+
+    template <typename MoveType>
+    void generatePawnMoves(std::vector<MoveType>& moves, const int square) {
+        const auto empty = ~(yellow_bits | black_bits);
+
+        for (const auto direction : {currentForward(), RIGHT, LEFT}) {
+            if (const auto landing_bit = shift(squareBit(square), direction) & empty)
+                addStep(moves, square, std::countr_zero(landing_bit));
+        }
+    }
+
+
+    // same as generatePawnCaptureMoves, except shaikhs fly. They may land on any empty square behind the captured piece,
+    // but can't turn back the way they came
+    template <typename MoveType>
+    void generateShaikhCaptureMoves(std::vector<MoveType>& moves, MoveType& move, const int square, const Bitboard own, const Bitboard opponent, const size_t forbidden_direction) {
+        bool continued = false;
+
+        const auto occupied = own | opponent;
+
+        for (const auto direction : {NORTH, EAST, SOUTH, WEST}) {
+            if (direction == forbidden_direction) continue;
+
+            const auto blockers = DISTANCE_RAYS[size_t(square)][direction] & occupied;
+            if (not blockers) continue;
+
+            // first piece in the way. Can't jump over my own piece
+            const auto capture_square = nearestSquare(blockers, direction);
+            if (not (squareBit(capture_square) & opponent)) continue;
+
+            // stops at the next piece, cannot jump over more than 1 opponent piece
+            for (auto landings = openRay(capture_square, direction, occupied); landings;) {
+                const auto landing_square = popNearest(landings, direction);
+
+                addCapture(move, landing_square, capture_square);
+
+                generateShaikhCaptureMoves(
+                    moves, move, landing_square,
+                    own ^ squareBit(square) ^ squareBit(landing_square), opponent ^ squareBit(capture_square),
+                    opposite(direction)
+                );
+
+                removeCapture(move, capture_square);
+
+                continued = true;
+            }
+        }
+
+        if (not continued and move.doesCapture()) addChain(moves, move, square);
+    }
+
+
+    template <typename MoveType>
+    void generateShaikhMoves(std::vector<MoveType>& moves, const int square) {
+        const auto occupied = yellow_bits | black_bits;
+
+        for (const auto direction : {NORTH, EAST, SOUTH, WEST}) {
+            for (auto landings = openRay(square, direction, occupied); landings;)
+                addStep(moves, square, popNearest(landings, direction));
+        }
+    }
+
+
+    // appends the side to move's moves to `moves`, and leaves whatever was already in there alone.
+    // The search keeps every ply's moves stacked in one vector this way, see move_stack
+    template <typename MoveType>
+    void generateMoves(std::vector<MoveType>& moves) {
+        const auto first_move = std::ptrdiff_t(moves.size());
+
+        // captures are mandatory, so there is no point looking at anything else
+        if (not hasCaptures()) {
+            for (auto pieces = ownBits(); pieces;) {
+                const auto square = popFirst(pieces);
+
+                if (squareBit(square) & shaikh_bits) generateShaikhMoves(moves, square);
+                else                                  generatePawnMoves(moves, square);
+            }
+
+            return;
+        }
+
+
+        MoveType move;
+        for (auto pieces = ownBits(); pieces;) {
+            const auto square = popFirst(pieces);
+
+            startChain(move, square);
+
+            if (squareBit(square) & shaikh_bits) generateShaikhCaptureMoves(moves, move, square, ownBits(), opponentBits(), NO_DIRECTION);
+            else                                  generatePawnCaptureMoves(moves, move, square, ownBits(), opponentBits());
+
+            endChain(move);
+        }
+
+
+        // possible_moves = std::ranges::remove_if(possible_moves, [] (const auto& move) { return not move.doesCapture(); }) | std::ranges::to<std::vector<Move>>();
+        // possible_moves.erase(std::remove_if(possible_moves.begin(), possible_moves.end(), [] (const auto& move) { return not move.doesCapture(); }), possible_moves.cend());
+        // std::erase_if(std::begin(possible_moves), std::end(possible_moves), )
+        const auto generated = std::ranges::subrange(moves.begin() + first_move, moves.end());
+        const auto max_captures = std::ranges::max_element(generated, {}, &MoveType::captureCount)->captureCount();
+        moves.erase(std::remove_if(generated.begin(), generated.end(), [max_captures] (const MoveType& move) { return move.captureCount() < max_captures; }), moves.end());
+    }
+
+    // populates the "possible_moves" member
+    void generateMoves() {
+        possible_moves.clear();
+        generateMoves(possible_moves);
+    }
+
+    // AI shit
+
+    // material and promotion distance, all of it kept in score as pieces move
+    int evaluate() const noexcept {
+        const int perspective = blackTurn() ? 1 : -1;
+        return perspective * score;
+    }
+
+
+    void makeMove(const Piece piece, const Move& move) noexcept {
+        const auto to = move.positions.back();
+
+        // origin first, a shaikh can capture its way back to where it started
+        reset(move.positions[0]);
+        set(to, piece);
+
+        if (to.y == 7 or to.y == 0 /* and not piece.isShaikh() */) promote(to);
+
+        for (const auto& [_, pos] : move.captures) reset(pos);
+
+        nextTurn();
+    }
+
+    void unMakeMove(const Piece piece, const Move& move) noexcept {
+        reset(move.positions.back());
+        set(move.positions[0], piece);
+
+        for (const auto& [captured_piece, pos] : move.captures) set(pos, captured_piece);
+
+        nextTurn();
+    }
+
+    // same thing for the search's moves
+    void makeMove(const Piece piece, const CompactMove move) noexcept {
+        const auto to = positionOf(move.to);
+
+        reset(positionOf(move.from));
+        set(to, piece);
+
+        if (to.y == 7 or to.y == 0) promote(to);
+
+        for (auto captures = move.captures; captures;) reset(positionOf(popFirst(captures)));
+
+        nextTurn();
+    }
+
+    // a CompactMove doesn't remember which of its captures were shaikhs, so the caller grabs
+    // `move.captures & shaikh_bits` before making the move and hands it back here
+    void unMakeMove(const Piece piece, const CompactMove move, const Bitboard captured_shaikhs) noexcept {
+        reset(positionOf(move.to));
+        set(positionOf(move.from), piece);
+
+        const auto captured_pawn = piece.isYellow() ? Piece{Piece::Flags::ACTIVE} : Piece::Flags::ACTIVE | Piece::Flags::YELLOW;
+        for (auto captures = move.captures; captures;) {
+            const auto square = popFirst(captures);
+            set(positionOf(square), squareBit(square) & captured_shaikhs ? captured_pawn | Piece::Flags::SHAIKH : captured_pawn);
+        }
+
+        nextTurn();
+    }
+
+    // the full Move, path and all, for one of this position's CompactMoves
+    Move toMove(const CompactMove move) {
+        generateMoves();
+
+        const auto found = std::ranges::find(possible_moves, move, &Move::compact);
+        return found != possible_moves.cend() ? *found : Move{};
+    }
+
+    // move_stack grows as needed, this just makes sure it doesn't have to
+    void reserveMoveStack() {
+        move_stack.clear();
+        move_stack.reserve(MOVE_STACK_SIZE);
+    }
+
+
+    // int minimax(int depth) {
+    //     if (not depth) return evaluate();
+
+    //     // populates the "possible_moves" member
+    //     generateMoves();
+    //     if (possible_moves.empty()) return -INF;
+
+
+
+    //     const auto moves = std::move(possible_moves);
+    //     int best = -INF;
+    //     for (const auto& move : moves) {
+    //         const auto piece = get(move.positions[0]);
+    //         makeMove(piece, move);
+    //         const int eval = -minimax(depth - 1);
+    //         unMakeMove(piece, move);
+
+    //         if (eval > best) best = eval;
+    //     }
+
+    //     return best;
+    // }
+
+    // visit order for moves[]: `first` goes first, then everything else in generated order
+    constexpr static size_t orderedIndex(const size_t n, const size_t first) noexcept {
+        if (n == 0) return first;
+        return n - 1 < first ? n - 1 : n;
+    }
+
+    // the clock isn't free, so it's only read every few thousand nodes
+    bool outOfTime() noexcept {
+        if (not stopped and nodes >= next_clock_check) {
+            next_clock_check = nodes + 4096;
+            stopped = std::chrono::steady_clock::now() >= deadline or stop_request.stop_requested();
+        }
+
+        return stopped;
+    }
+
+
+    int alphaBeta(int depth, int alpha = -INF, int beta = INF) {
+        ++nodes;
+
+        // nothing left to search, it's been worked out ahead of time
+        if (const auto known = probeTablebase()) return std::clamp(*known, alpha, beta);
+
+        if (depth <= 0) return evaluate();
+
+        if (outOfTime()) return 0; // bestMove throws away anything searched after this
+
+
+        // this position was seen before, maybe searched deep enough to not bother again
+        size_t first{};
+        if (const auto entry = table->probe(hash)) {
+            if (entry->depth >= depth) {
+                if (entry->bound == Bound::EXACT) return std::clamp(entry->score, alpha, beta);
+                if (entry->bound == Bound::LOWER and entry->score >= beta ) return beta;
+                if (entry->bound == Bound::UPPER and entry->score <= alpha) return alpha;
+            }
+
+            // either way, what was best last time is likely to be best again
+            first = entry->move;
+        }
+
+        // this ply's moves go on top of the ones the plies above are still going through
+        const auto first_move = move_stack.size();
+        generateMoves(move_stack);
+
+        const auto move_count = move_stack.size() - first_move;
+        if (move_count == 0) return -INF;
+
+        if (first >= move_count) first = 0; // the entry came from some other position with the same hash
+
+
+        // // basically saying if we reached the depth, but we're in a capturing position
+        // // keep going. Untill there is no captures left!
+        // if (depth <= 0 and not moves[0].doesCapture()) return evaluate();
+
+
+        size_t best_idx = first;
+        auto bound = Bound::UPPER;
+        for (const auto n : range(move_count)) {
+            const auto idx = orderedIndex(n, first);
+            const auto move = move_stack[first_move + idx]; // a copy, the stack may move while searching below
+            const auto piece = get(positionOf(move.from));
+            const auto captured_shaikhs = move.captures & shaikh_bits;
+
+            makeMove(piece, move);
+            const int eval = -alphaBeta(depth - 1, -beta, -alpha);
+            unMakeMove(piece, move, captured_shaikhs);
+
+            if (stopped) break;
+
+            // if move is too good
+            if (eval >= beta) { // prune the brach!
+                alpha = beta;
+                best_idx = idx;
+                bound = Bound::LOWER;
+                break;
+            }
+
+            if (eval > alpha) {
+                alpha = eval;
+                best_idx = idx;
+                bound = Bound::EXACT;
+            }
+        }
+
+        move_stack.resize(first_move);
+
+        if (stopped) return 0;
+
+        table->store(hash, depth, alpha, bound, best_idx);
+        return alpha;
+    }
+
+
+    // `stop` lets another thread cut the search short, see AsyncSearch.
+    // With more than one thread this is lazy SMP: helpers search the same position on their own copies of the board
+    // and all of them share the table. Whatever a helper finishes first the main search finds there instead of
+    // searching it again. Only the main search's answer counts, so one thread is exactly the serial search
+    Move bestMove(const SearchLimits limits = {}, const std::stop_token stop = {}) {
+        if (not table) table = std::make_shared<TranspositionTable>();
+
+        if (limits.threads <= 1) return iterativeDeepening(limits, stop);
+
+
+        std::stop_source helpers_stop;
+        const std::stop_callback forward_stop{stop, [&helpers_stop] { helpers_stop.request_stop(); }};
+
+        std::vector<Board> helpers(size_t(limits.threads - 1), *this);
+
+        std::vector<std::jthread> threads;
+        threads.reserve(helpers.size());
+        for (const auto i : range(helpers.size())) {
+            // every other helper starts a ply deeper, so they aren't all working on the same iteration
+            threads.emplace_back([&helper = helpers[i], limits, token = helpers_stop.get_token(), i] {
+                helper.iterativeDeepening(limits, token, 1 + int(i % 2));
+            });
+        }
+
+        const auto move = iterativeDeepening(limits, stop);
+
+        helpers_stop.request_stop();
+        threads.clear(); // joins
+
+        for (const auto& helper : helpers) nodes += helper.nodes;
+
+        return move;
+    }
+
+
+    // depth 1, then 2, ... until the limits run out. Every iteration starts with the previous one's best move,
+    // and the table remembers the rest, so the shallow ones cost little and make the deep ones cheaper
+    Move iterativeDeepening(const SearchLimits limits, const std::stop_token stop, const int first_depth = 1) {
+        nodes = 0;
+        searched_depth = 0;
+        searched_score = 0;
+        next_clock_check = 0;
+        stopped = false;
+        deadline = std::chrono::steady_clock::now() + limits.time;
+        stop_request = stop;
+
+        // the root's moves sit at the bottom of the stack for the whole search
+        reserveMoveStack();
+        generateMoves(move_stack);
+
+        const auto move_count = move_stack.size();
+        if (move_count <= 1) return move_count == 0 ? Move{} : toMove(move_stack[0]); // nothing to think about
+
+        size_t best_idx{};
+        for (int depth = first_depth; depth <= limits.depth and not stopped; ++depth) {
+            const auto previous_best = best_idx;
+
+            // the first move always scores above this
+            int best_score = -INF - 1;
+            for (const auto n : range(move_count)) {
+                const auto idx = orderedIndex(n, previous_best);
+                const auto move = move_stack[idx];
+                const auto piece = get(positionOf(move.from));
+                const auto captured_shaikhs = move.captures & shaikh_bits;
+
+                makeMove(piece, move);
+                const auto score = -alphaBeta(depth - 1, -INF - 1, -best_score);
+                unMakeMove(piece, move, captured_shaikhs);
+
+                // a cut short iteration still counts for the moves it finished. The previous best went first,
+                // so anything that beat it is better for sure
+                if (stopped) break;
+
+                if (score > best_score) {
+                    best_score = score;
+                    best_idx   = idx;
+                }
+            }
+
+            if (stopped) break;
+
+            searched_depth = depth;
+            searched_score = best_score;
+            table->store(hash, depth, best_score, Bound::EXACT, best_idx);
+        }
+
+        // std::clog << (yellowTurn() ? "yellow's score: " : "black's score: ") << best_score << '\n';
+        return toMove(move_stack[best_idx]);
+    }
+
+
+    // number of move sequences `depth` plies long. Counts are easy to check against, which makes this the move generation test
+    size_t perft(const int depth) {
+        if (move_stack.capacity() == 0) reserveMoveStack();
+
+        if (depth <= 0) return 1;
+
+        const auto first_move = move_stack.size();
+        generateMoves(move_stack);
+
+        const auto move_count = move_stack.size() - first_move;
+
+        size_t total = depth == 1 ? move_count : 0;
+        for (const auto i : range(depth == 1 ? 0uz : move_count)) {
+            const auto move = move_stack[first_move + i];
+            const auto piece = get(positionOf(move.from));
+            const auto captured_shaikhs = move.captures & shaikh_bits;
+
+            makeMove(piece, move);
+            total += perft(depth - 1);
+            unMakeMove(piece, move, captured_shaikhs);
+        }
+
+        move_stack.resize(first_move);
+        return total;
+    }
+
+
+    void parseFen(const std::string_view fen) noexcept {
+        yellow_bits = black_bits = shaikh_bits = 0;
+        recomputeIncremental();
+
+        for(int x{}, y{}; char c : fen){
+            switch(c){
+                case 'y':
+                    set({x, y}, Piece::Flags::ACTIVE | Piece::Flags::YELLOW);
+                    ++x;
+                    break;
+                case 'Y':
+                    set({x, y}, Piece::Flags::ACTIVE | Piece::Flags::YELLOW | Piece::Flags::SHAIKH);
+                    ++x;
+                    break;
+                case 'b':
+                    set({x, y}, Piece::Flags::ACTIVE); // active assumed to be black pawn
+                    ++x;
+                    break;
+                case 'B':
+                    set({x, y}, Piece::Flags::ACTIVE | Piece::Flags::SHAIKH);
+                    ++x;
+                    break;
+                case '/':
+                    ++y;
+                    x = 0;
+                    break;
+                default:
+                    x += c - '0';
+                    break;
+            }
+        }
+    }
+
+    void prettyPrint() const {
+        std::clog << "==================\n";
+
+        for (const auto y : range(8)) {
+            for (const auto x : range(8)) {
+                get({x, y}).prettyPrint();
+            }
+            std::clog << '\n';
+        }
+
+        std::clog << "==================\n";
+    }
+
+    static void printMoves(const std::vector<Move>& moves) {
+        for (auto&& [idx, move] : enumerate(moves)) {
+            std::clog << '[' << idx << "]: ";
+            move.prettyPrint();
+        }
+    }
+
+
+    std::string fen() const {
+        std::string out;
+
+        for (size_t count; const auto y : range(8)) {
+            count = 0;
+            for (const auto x : range(8)) {
+                if (const auto piece = get({x, y})) {
+                    if (count) out += std::to_string(count);
+
+                    count = 0;
+                    out += piece.symbol();
+                }
+                else ++count;
+            }
+
+            if (count) out += std::to_string(count);
+
+            out += '/';
+        }
+
+        out.pop_back();
+        return out;
+    }
+};
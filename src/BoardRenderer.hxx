@@ -0,0 +1,272 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <array>
+#include <utility>
+
+#include <SFML/Graphics.hpp>
+
+#include "Piece.hxx"
+#include "Position.hxx"
+#include "helper.hxx"
+
+
+#define ASSETS_PATH "src/assets/"
+#define  FONTS_PATH ASSETS_PATH "fonts/"
+#define IMAGES_PATH ASSETS_PATH "images/"
+#define SOUNDS_PATH ASSETS_PATH "sfx/"
+
+
+constexpr sf::Color  DARK_TILE      = {107, 77 , 64 };
+constexpr sf::Color LIGHT_TILE      = {240, 201, 152};
+
+constexpr sf::Color  DARK_HIGHLIGHT = {53 , 181, 87 };
+constexpr sf::Color LIGHT_HIGHLIGHT = {71 , 173, 98 };
+
+constexpr sf::Color   RED_HIGHLIGHT = {189, 60 , 0  };
+constexpr sf::Color  BLUE_HIGHLIGHT = {41 , 74 , 153};
+
+constexpr sf::Color AWAY_COLOR  = {32, 20 ,  0};
+constexpr sf::Color HOME_COLOR  = {204, 126, 0};
+
+
+[[clang::no_destroy]] const inline sf::Font FONT{FONTS_PATH "Roboto-Regular.ttf"};
+[[clang::no_destroy]] const inline sf::Texture CROWN_IMAGE{IMAGES_PATH "crown_brown.png", false, sf::IntRect{{0, 0}, {512, 512}}};
+
+
+// sizes for a window this big. The board is square and fills it
+inline float   blockSize(const sf::Vector2u window_size) noexcept { return static_cast<float>(window_size.x / 8 ); }
+inline float pieceRadius(const sf::Vector2u window_size) noexcept { return static_cast<float>(window_size.x / 20); } // / 10 / 2
+
+
+// draws the board doing as little as possible each frame. The tiles and coordinates never change, so they're drawn
+// into textures once. Everything else (highlights, pieces, step numbers) is a square cut out of one more texture
+// drawn up front, the atlas, so a whole frame of them goes out in two draw calls: the squares under the
+// coordinates, the pieces over them
+class BoardRenderer {
+    // what's where in the atlas. Every cell is one block big
+    enum Cell : int { SOLID, YELLOW_PAWN, YELLOW_SHAIKH, BLACK_PAWN, BLACK_SHAIKH, FIRST_STEP };
+
+    constexpr static int MAX_STEPS = 15; // a Move has 16 positions at most
+    constexpr static int ATLAS_COLUMNS = 8;
+    constexpr static int ATLAS_ROWS = (FIRST_STEP + MAX_STEPS + ATLAS_COLUMNS - 1) / ATLAS_COLUMNS;
+
+    sf::Vector2u window_size;
+    float block_size;
+
+    sf::RenderTexture board;
+    sf::RenderTexture labels; // the coordinates, on their own so highlights can go between them and the tiles
+    sf::RenderTexture atlas;
+    sf::Sprite board_sprite;
+    sf::Sprite labels_sprite;
+
+    // triangles, two per square. Refilled for every frame that gets drawn
+    sf::VertexArray squares{sf::PrimitiveType::Triangles}; // highlights and step numbers
+    sf::VertexArray  pieces{sf::PrimitiveType::Triangles};
+
+    sf::Text message{FONT, "", 64};
+    sf::Text stats{FONT, "", 14};
+    bool show_message = false;
+    bool show_stats = true;
+
+public:
+    size_t draw_calls{}; // by the last draw()
+
+
+    explicit BoardRenderer(const sf::Vector2u size)
+    : window_size{size}
+    , block_size{blockSize(size)}
+    , board{size}
+    , labels{size}
+    , atlas{{static_cast<unsigned>(block_size) * ATLAS_COLUMNS, static_cast<unsigned>(block_size) * ATLAS_ROWS}}
+    , board_sprite{board.getTexture()}
+    , labels_sprite{labels.getTexture()}
+    {
+        drawBoard();
+        drawLabels();
+        drawAtlas();
+
+        message.setOutlineThickness(2);
+        stats.setOutlineThickness(1);
+        stats.setOutlineColor(sf::Color::Black);
+    }
+
+    BoardRenderer(const BoardRenderer&) = delete;
+    BoardRenderer& operator=(const BoardRenderer&) = delete;
+
+
+    sf::Vector2f squareCorner(const Position pos) const noexcept { return {pos.x * block_size, pos.y * block_size}; }
+    sf::Vector2f squareCentre(const Position pos) const noexcept { return squareCorner(pos) + sf::Vector2f{block_size / 2, block_size / 2}; }
+
+
+    // starts a new frame, nothing from the last one is kept
+    void clear() noexcept {
+        squares.clear();
+        pieces.clear();
+        show_message = false;
+    }
+
+    void square(const Position pos, const sf::Color color) { quad(squares, squareCorner(pos), SOLID, color); }
+
+    // the little number in the corner of a square, which hop of the move lands there
+    void step(const Position pos, const int step) {
+        if (step >= 1 and step <= MAX_STEPS) quad(squares, squareCorner(pos), FIRST_STEP + step - 1);
+    }
+
+    void piece(const Piece piece, const sf::Vector2f centre) {
+        if (not piece.isActive()) return;
+        quad(pieces, centre - sf::Vector2f{block_size / 2, block_size / 2}, pieceCell(piece));
+    }
+
+    // big text across the middle, for the end of the game
+    void showMessage(const std::string_view text) {
+        message.setString(std::string{text});
+
+        const sf::FloatRect bounds = message.getLocalBounds();
+        message.setOrigin({bounds.position.x + bounds.size.x / 2, bounds.position.x + bounds.size.y / 2});
+        message.setPosition({static_cast<float>(window_size.x / 2), static_cast<float>(window_size.y / 2)});
+
+        show_message = true;
+    }
+
+    void setStats(const std::string_view text) {
+        stats.setString(std::string{text});
+        stats.setPosition({static_cast<float>(window_size.x) - stats.getLocalBounds().size.x - 8, 4});
+    }
+
+    void toggleStats() noexcept { show_stats = not show_stats; }
+    bool statsShown() const noexcept { return show_stats; }
+
+
+    void draw(sf::RenderWindow& window) {
+        window.clear();
+
+        sf::RenderStates states;
+        states.texture = &atlas.getTexture();
+
+        // same order the board was always drawn in: tiles, highlights, coordinates, pieces
+        window.draw(board_sprite);
+        window.draw(squares, states);
+        window.draw(labels_sprite);
+        window.draw(pieces, states);
+        draw_calls = 4;
+
+        if (show_message) {
+            window.draw(message);
+            ++draw_calls;
+        }
+
+        if (show_stats) {
+            window.draw(stats);
+            ++draw_calls;
+        }
+    }
+
+
+private:
+    sf::Vector2f cellCorner(const int cell) const noexcept {
+        return {static_cast<float>(cell % ATLAS_COLUMNS) * block_size, static_cast<float>(cell / ATLAS_COLUMNS) * block_size};
+    }
+
+    static Cell pieceCell(const Piece piece) noexcept {
+        if (piece.isYellow()) return piece.isShaikh() ? YELLOW_SHAIKH : YELLOW_PAWN;
+        return piece.isShaikh() ? BLACK_SHAIKH : BLACK_PAWN;
+    }
+
+    void quad(sf::VertexArray& batch, const sf::Vector2f corner, const int cell, const sf::Color color = sf::Color::White) {
+        const auto texture_corner = cellCorner(cell);
+
+        const std::array<sf::Vector2f, 6> offsets = {{
+            {0, 0}, {block_size, 0}, {0, block_size},
+            {block_size, 0}, {block_size, block_size}, {0, block_size},
+        }};
+
+        for (const auto offset : offsets) batch.append({corner + offset, color, texture_corner + offset});
+    }
+
+
+    void drawBoard() {
+        board.clear();
+
+        sf::RectangleShape block{{block_size, block_size}};
+        for (const auto y : range(8)) {
+            for (const auto x : range(8)) {
+                block.setPosition(squareCorner({x, y}));
+                block.setFillColor((x + y) % 2 ? LIGHT_TILE : DARK_TILE);
+                board.draw(block);
+            }
+        }
+
+        board.display();
+    }
+
+    // letters along the bottom, numbers down the left, each with a shadow. Clear everywhere else
+    void drawLabels() {
+        labels.clear(sf::Color::Transparent);
+
+        sf::Text text{FONT, "", 18};
+        const auto label = [this, &text] (const std::string& string, const sf::Vector2f pos) {
+            text.setString(string);
+
+            text.setPosition(pos + sf::Vector2f{2, 2});
+            text.setFillColor(sf::Color::Black);
+            labels.draw(text);
+
+            text.setPosition(pos);
+            text.setFillColor(sf::Color::White);
+            labels.draw(text);
+        };
+
+        for (const auto x : range(8)) label(std::string(1, char('A' + x)), squareCorner({x, 7}) + sf::Vector2f{block_size - 20, block_size - 25});
+        for (const auto y : range(8)) label(std::to_string(8 - y),         squareCorner({0, y}) + sf::Vector2f{5, 1});
+
+        labels.display();
+    }
+
+    void drawAtlas() {
+        atlas.clear(sf::Color::Transparent);
+
+        sf::RectangleShape solid{{block_size, block_size}};
+        solid.setPosition(cellCorner(SOLID));
+        solid.setFillColor(sf::Color::White);
+        atlas.draw(solid);
+
+        const auto radius = pieceRadius(window_size);
+        for (const auto flags : {Piece::Flags::YELLOW, Piece::Flags::YELLOW | Piece::Flags::SHAIKH, Piece::Flags::NONE, Piece::Flags::SHAIKH}) {
+            const Piece piece = Piece::Flags::ACTIVE | flags;
+            const auto centre = cellCorner(pieceCell(piece)) + sf::Vector2f{block_size / 2, block_size / 2};
+
+            sf::CircleShape circle{radius};
+            circle.setFillColor(piece.isYellow() ? HOME_COLOR : AWAY_COLOR);
+            circle.setOrigin({radius, radius});
+            circle.setPosition(centre);
+            atlas.draw(circle);
+
+            if (piece.isShaikh()) {
+                sf::Sprite crown{CROWN_IMAGE};
+                crown.setOrigin({256, 256});
+                crown.setScale({.1f, .1f});
+                crown.setPosition(centre);
+                atlas.draw(crown);
+            }
+        }
+
+        // where highlighMove used to put them in a square, shadow first
+        sf::Text text{FONT, "", 18};
+        for (const auto step : range(1, MAX_STEPS + 1)) {
+            const auto corner = cellCorner(FIRST_STEP + step - 1) + sf::Vector2f{block_size - 20, 1};
+            text.setString(std::to_string(step));
+
+            text.setPosition(corner + sf::Vector2f{2, 2});
+            text.setFillColor(sf::Color::Black);
+            atlas.draw(text);
+
+            text.setPosition(corner);
+            text.setFillColor(sf::Color::White);
+            atlas.draw(text);
+        }
+
+        atlas.display();
+    }
+};
@@ -1,93 +1,30 @@
 #pragma once
 
 #include <iostream>
-#include <cmath>
 #include <string_view>
 #include <vector>
-#include <array>
 #include <algorithm>
-#include <thread>
-#include <chrono>
 #include <span>
-#include <limits>
-#include <ranges>
-#include <utility>
+#include <tuple>
+#include <cmath>
 
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
 
 
+#include "Board.hxx"
+#include "BoardRenderer.hxx"
 #include "Piece.hxx"
 #include "Move.hxx"
+#include "Bitboard.hxx"
 #include "helper.hxx"
 
 
-constexpr auto INF = 100000;
-
-
-// for some reason can't put this as a method
-consteval auto precomputeDistancePositions() {
-    std::array<std::array<std::array<static_vector<Position, 8>, 4>, 8>, 8> data{};
-
-    for(const auto i : range(8uz)){
-        for(const auto j : range(8uz)){
-            const auto num_north = i;
-            const auto num_east  = 8 - j - 1;
-            const auto num_south = 8 - i - 1;
-            const auto num_west  = j;
-
-            for (const auto e : range(1, num_north +1)) data[i][j][0].push_back({ 0, -e});
-            for (const auto e : range(1, num_east  +1)) data[i][j][1].push_back({ e,  0});
-            for (const auto e : range(1, num_south +1)) data[i][j][2].push_back({ 0,  e});
-            for (const auto e : range(1, num_west  +1)) data[i][j][3].push_back({-e,  0});
-
-            // data[i][j] = {num_north, num_east, num_south, num_west};
-        }
-    }
-
-    return data;
-}
-
-constexpr inline auto DISTANCE_POSITIONS = precomputeDistancePositions();
-constexpr inline std::array<std::pair<int, int>, 8> PROMOTION_DISTANCE = {{
-    {0  , 120},
-    {0  , 90 },
-    {0  , 60 },
-    {0  , 30 },
-    {30 , 0  },
-    {60 , 0  },
-    {90 , 0  },
-    {120, 0  }
-}};
-
-
-
-class BoardState {
-    constexpr static std::string_view STARTING_FEN = "8/bbbbbbbb/bbbbbbbb/8/8/yyyyyyyy/yyyyyyyy/8";
-
-    // whoever is true, goes first
-    constexpr static auto YELLOW_TURN = true;
-    constexpr static auto BLACK_TURN  = not YELLOW_TURN;
-
-    constexpr static auto YELLOW_FORWARD = YELLOW_TURN ? Position{0, -1} :  Position{0, 1}; // yellow goes up, which is in the negative direction
-    constexpr static auto BLACK_FORWARD  = -YELLOW_FORWARD;
-    constexpr static auto RIGHT = Position{ 1, 0};
-    constexpr static auto LEFT  = Position{-1, 0};
-
-
-    std::uint64_t board_bits;
-
-    std::array<std::array<Piece, 8>, 8> board;
-
-public:
-    bool turn = YELLOW_TURN;
-private:
-
-    std::vector<Move> possible_moves;
-
+// the board on screen: dragging pieces around, stepping the AI's moves and the sounds that go with them
+class BoardState : public Board {
     bool prev_holding = false;
     bool curr_holding = false;
-    Piece *dragging = nullptr;
+    Piece dragging; // copy of the held piece, inactive if nothing is held
     int holding_x, holding_y;
     std::vector<Move> holding_moves;
     // Move inflight;
@@ -95,41 +32,21 @@ private:
     bool inflight = false; // is in the middle of a move?
 
 public:
-    explicit constexpr BoardState(const std::string_view fen = STARTING_FEN, bool yellow_starts = true) noexcept
-    : turn{yellow_starts}
-    {
-        parseFen(fen);
-        generateMoves();
-    }
+    explicit BoardState(const std::string_view fen = STARTING_FEN, bool yellow_starts = true) noexcept
+    : Board{fen, yellow_starts}
+    {}
 
-    explicit constexpr BoardState(bool yellow_starts) noexcept
-    : turn{yellow_starts}
-    {
-        parseFen(STARTING_FEN);
-        generateMoves();
-    }
+    explicit BoardState(bool yellow_starts) noexcept
+    : Board{yellow_starts}
+    {}
 
-    size_t yellowCount() const noexcept {
-        size_t count{};
-        for (const auto& row : board) for (const auto piece : row) count += piece.isActive() and piece.isYellow();
-        return count;
-    }
-
-    size_t blackCount() const noexcept {
-        size_t count{};
-        for (const auto& row : board) for (const auto piece : row) count += piece.isActive() and piece.isBlack();
-        return count;
-    }
-
-    bool done() const noexcept { return yellowCount() == 0 or blackCount() == 0; }
 
+    // nothing new to pick from while the player is mid capture
+    void generateMoves() {
+        if (inflight) return possible_moves.clear();
 
-    bool yellowTurn() const noexcept { return turn == YELLOW_TURN; }
-    bool blackTurn()  const noexcept { return turn == BLACK_TURN;  }
-    void nextTurn() noexcept { turn =! turn; }
-    auto currentForward() const noexcept { return yellowTurn() ? YELLOW_FORWARD : BLACK_FORWARD; }
-          auto& get(const Position pos)       noexcept { return board[size_t(pos.y)][size_t(pos.x)]; }
-    const auto& get(const Position pos) const noexcept { return board[size_t(pos.y)][size_t(pos.x)]; }
+        Board::generateMoves();
+    }
 
 
     void checkPressed(sf::RenderWindow& window) {
@@ -139,33 +56,31 @@ public:
         if (not prev_holding and not dragging and curr_holding) {
             const auto [mouse_x, mouse_y] = sf::Mouse::getPosition(window);
 
-            for (const auto [y, row] : enumerate(board)) {
-                for (const auto [x, piece] : enumerate(row)) {
-                    // if not active or not the turn
-                    if (not piece.isActive() or piece.isYellow() != yellowTurn()) continue;
+            // only the pieces whose turn it is
+            for (auto pieces = ownBits(); pieces;) {
+                const auto [x, y] = positionOf(popFirst(pieces));
 
-                    const auto shape = piece.getShape(window, {static_cast<float>(x), static_cast<float>(y)});
-                    if (shape.getGlobalBounds().contains({static_cast<float>(mouse_x), static_cast<float>(mouse_y)})) {
-                        dragging = &piece;
-                        holding_x = static_cast<int>(x);
-                        holding_y = static_cast<int>(y);
-                        piece.setDragged(true);
+                // the box around the circle, same as its bounds used to be
+                const auto block_size = blockSize(window.getSize());
+                const auto radius = pieceRadius(window.getSize());
+                const auto centre_x = x * block_size + block_size / 2;
+                const auto centre_y = y * block_size + block_size / 2;
 
-                        // holding_moves.clear();
+                if (std::abs(mouse_x - centre_x) <= radius and std::abs(mouse_y - centre_y) <= radius) {
+                    dragging = get({x, y});
+                    holding_x = x;
+                    holding_y = y;
+                    dragging.setDragged(true);
 
-                        if (not inflight) for (const auto& move : possible_moves) {
-                            if (move.positions[0].x == static_cast<int>(x) and move.positions[0].y == static_cast<int>(y)) {
-                                holding_moves.push_back(move);
-                            }
-                        }
-                        else for (const auto& move : possible_moves) {
-                            if (move.positions[0].x == static_cast<int>(x) and move.positions[0].y == static_cast<int>(y)) {
-                                holding_moves.push_back(move);
-                            }
-                        }
+                    // holding_moves.clear();
 
-                        return; // break the double loops
+                    for (const auto& move : possible_moves) {
+                        if (move.positions[0].x == x and move.positions[0].y == y) {
+                            holding_moves.push_back(move);
+                        }
                     }
+
+                    return;
                 }
             }
         }
@@ -185,8 +100,7 @@ public:
             const int x = int(mouse_x / block_size);
             const int y = int(mouse_y / block_size);
 
-            dragging->setDragged(false);
-            dragging = nullptr;
+            dragging.reset();
 
             if (x == holding_x and y == holding_y) return holding_moves.clear();
 
@@ -200,17 +114,17 @@ public:
                 if (move_iter == holding_moves.cend()) return holding_moves.clear();
 
 
-                get({x, y}) = get({holding_x, holding_y});
-                get({holding_x, holding_y}).reset();
+                set({x, y}, get({holding_x, holding_y}));
+                reset({holding_x, holding_y});
 
                 if (not get({x, y}).isShaikh() and  (y == 0 or y == 7)) {
-                    get({x, y}).promote();
+                    promote({x, y});
                     sound_fx = SoundFX::PROMOTE;
                 }
 
 
                 if (move_iter->doesCapture()) {
-                    get(move_iter->captures[0].pos).reset();
+                    reset(move_iter->captures[0].pos);
 
                     if (sound_fx != SoundFX::PROMOTE) sound_fx = SoundFX::CAPTURE;
                 }
@@ -243,18 +157,18 @@ public:
                 if (move_iter == possible_moves.cend()) return holding_moves.clear();
 
 
-                get({x, y}) = get({holding_x, holding_y});
-                get({holding_x, holding_y}).reset();
+                set({x, y}, get({holding_x, holding_y}));
+                reset({holding_x, holding_y});
 
                 if (not get({x, y}).isShaikh() and  (y == 0 or y == 7)) {
-                    get({x, y}).promote();
+                    promote({x, y});
                     sound_fx = SoundFX::PROMOTE;
                 }
 
                 // this must be a capturing move since we're during an inflight move
                 if (sound_fx != SoundFX::PROMOTE) sound_fx = SoundFX::CAPTURE;
 
-                get(move_iter->captures[0].pos).reset();
+                reset(move_iter->captures[0].pos);
 
                 if (move_iter->positions.size() == 2) {
                     inflight = false;
@@ -283,7 +197,11 @@ public:
 
 
 
-    std::tuple<std::span<Move>, std::span<Move>, Move> update(sf::RenderWindow& window) {
+    // the mouse only counts on the player's turn. possible_moves holds the AI's moves while it thinks and hops, and
+    // those aren't for the player to pick from, or to highlight
+    std::tuple<std::span<Move>, std::span<Move>, Move> update(sf::RenderWindow& window, const bool players_turn) {
+        if (not players_turn) return {std::span<Move>{}, std::span<Move>{}, AI_highlighs};
+
         checkPressed(window);
         checkReleased(window);
 
@@ -291,373 +209,26 @@ public:
     }
 
 
-    void render(sf::RenderWindow& window) const {
-        for (const auto [y, row] : enumerate(board)) {
-            for (const auto [x, piece] : enumerate(row)) {
-                if (not piece.isDragged()) piece.render(window, {static_cast<float>(x), static_cast<float>(y)});
-            }
-        }
-
-        if (dragging) {
-            const auto [x, y] = sf::Mouse::getPosition(window);
-            dragging->render(window, {static_cast<float>(x), static_cast<float>(y)}, true);
-        }
-    }
-
-    constexpr static bool isValidPosition(const Position pos) noexcept {
-        return pos.x >= 0 and pos.x < 8 and pos.y >= 0 and pos.y <8;
-    }
-
-
-    void simulateCapture(const Piece piece, const Position from, const Position capture, const Position to) noexcept {
-        get(from).reset();
-        get(capture).reset();
-        get(to) = piece;
-    }
-
-    void unsimulateCapture(const Piece piece, const Piece captured_piece, const Position from, const Position capture, const Position to) noexcept {
-        get(from) = piece;
-        get(capture) = captured_piece;
-        get(to).reset();
-    }
-
-
-    std::vector<Move> generatePawnCaptureMoves(const Piece piece, const Position pos) {
-        std::vector<Move> moves;
-
-        if (pos.y != 0 and pos.y != 7) {
-            const auto forward = currentForward();
+    void render(BoardRenderer& renderer, const sf::RenderWindow& window) const {
+        for (auto pieces = yellow_bits | black_bits; pieces;) {
+            const auto pos = positionOf(popFirst(pieces));
 
-            for(const auto direction : {forward, RIGHT, LEFT}) {
-                const auto capture_pos = pos + direction;
-                const auto captured_piece = get(capture_pos); 
-                const auto landing_pos = capture_pos + direction;
+            // the held piece follows the mouse instead
+            if (dragging and pos.x == holding_x and pos.y == holding_y) continue;
 
-
-                if (
-                       not isValidPosition(landing_pos)              // outside the board
-                    or not captured_piece.isActive()                 // not capturing a piece
-                    or   get(landing_pos).isActive()                 // landing at an occupied position
-                    or     captured_piece.isYellow() == yellowTurn() // captured piece is not the opponent's
-                ) continue;
-
-
-                  simulateCapture(piece,                 pos, capture_pos, landing_pos);
-                const auto continuations = generatePawnCaptureMoves(piece,  landing_pos);
-                unsimulateCapture(piece, captured_piece, pos, capture_pos, landing_pos);
-
-                if (continuations.empty()) {
-                    moves.push_back({{pos, landing_pos}, {{captured_piece, capture_pos}, }});
-                }
-                else for (const auto& cont : continuations) {
-                    Move move{{pos, /* landing_pos */ }, {{captured_piece, capture_pos}, }};
-                    for (const auto& position : cont.positions) {
-                        move.positions.push_back(position);
-                    }
-
-                    for (const auto& capture : cont.captures) {
-                        move.captures.push_back(capture);
-                    }
-
-                    moves.push_back(move);
-                }
-            }
-        }
-
-
-        return moves;
-    }
-
-
-    std::vector<Move> generatePawnMoves(const Piece piece, const Position pos) {
-        const auto forward = currentForward();
-
-        std::vector<Move> moves;
-        for (const auto direction : {forward, RIGHT, LEFT}) {
-            const auto landing_pos = pos + direction;
-
-            if (not isValidPosition(landing_pos)) continue;
-
-
-            if (const auto landing_piece = get(landing_pos); not landing_piece.isActive()) {
-                moves.push_back({{pos, landing_pos}});
-            }
-            else if (landing_piece.isYellow() != yellowTurn()) { // landing piece is an opponent piece
-                auto capture_moves = generatePawnCaptureMoves(piece, pos);
-                moves.insert_range(moves.cend(), std::move(capture_moves));
-            }
-        }
-
-        return moves;
-    }
-
-
-    std::vector<Move> generateShaikhCaptureMoves(const Piece piece, const Position pos, const size_t forbidden_direction) {
-        std::vector<Move> moves;
-
-
-        for (const auto direction_idx : range(4uz)) {
-            if (direction_idx == forbidden_direction) continue;
-
-            Position capture_pos;
-            Piece captured_piece;
-            for(int count{}; const auto distance : DISTANCE_POSITIONS[size_t(pos.y)][size_t(pos.x)][direction_idx]) {
-                const auto landing_pos = pos + distance;
-
-                const auto landing_piece = get(landing_pos);
-
-                if (landing_piece.isActive()) {
-                    if (landing_piece.isYellow() == yellowTurn()) break; // can't jump over my own piece. Go to next direction
-
-                    // landing_piece.isYellow() != yellowTurn()
-                    // counting the opponents pieces I encounter
-                    else {
-                        ++count;                                                                   // up here v
-                        if (count == 1) {
-                            capture_pos = landing_pos;
-                            captured_piece = get(capture_pos);
-                        }
-                        // count has to be greater than 1 since it starts as 0 and we're incrementing up there ^
-                        else break; // cannot jump over more than 1 opponent piece
-                    }
-                }
-
-                // not landing_piece.isActive()
-                else {
-                    if (count == 1) {
-
-                        simulateCapture(piece,                 pos, capture_pos,     landing_pos);
-                        const auto continuations = generateShaikhCaptureMoves(piece, landing_pos, (direction_idx + 2) % 4);
-                        unsimulateCapture(piece, captured_piece, pos, capture_pos,   landing_pos);
-
-
-                        if (continuations.empty()) {
-                            moves.push_back({{pos, landing_pos}, {{captured_piece, capture_pos}, }});
-                        }
-                        else for (const auto& cont : continuations) {
-                            Move move{{pos, /* landing_pos */ }, {{captured_piece, capture_pos}, }};
-                            for (const auto& position : cont.positions) {
-                                move.positions.push_back(position);
-                            }
-
-                            for (const auto& capture : cont.captures) {
-                                move.captures.push_back(capture);
-                            }
-
-                            moves.push_back(move);
-                        }
-                    }
-                }
-            }
+            renderer.piece(get(pos), renderer.squareCentre(pos));
         }
 
-        return moves;
-    }
-
-
-    std::vector<Move> generateShaikhMoves(const Piece piece, const Position pos) {
-        std::vector<Move> moves;
-
-        for (const auto direction_idx : range(4uz)) {
-
-                // counting opponent's pieces across a certain direction. 
-            for (size_t count{}; const auto distance : DISTANCE_POSITIONS[size_t(pos.y)][size_t(pos.x)][direction_idx]) {
-                const auto landing_pos = pos + distance;
-
-                const auto landing_piece = get(landing_pos);
-
-                if (landing_piece.isActive()) {
-                    if (landing_piece.isYellow() == yellowTurn()) break; // can't jump over my own piece. Go to next direction
-
-                    // landing_piece.isYellow() != yellowTurn()
-                    // counting the opponents pieces I encounter
-                    else if (++count > 1) break; // cannot jump over more than 1 opponent piece
-                }
-
-                // not landing_piece.isActive()
-                else {
-                    if (count == 0) {
-                        moves.push_back({{pos, landing_pos}});
-                    }
-                    if (count == 1) {
-                        auto capture_moves = generateShaikhCaptureMoves(piece, pos, (direction_idx + 2) % 4);
-                        moves.insert_range(moves.cend(), std::move(capture_moves));
-                    }
-                }
-            }
-        }
-
-        return moves;
-    }
-
-
-    // populates the "possible_moves" member
-    void generateMoves() {
-        possible_moves.clear();
-
-        if (inflight) return;
-
-        for (const auto [y, row] : enumerate(board)) {
-            for (const auto [x, piece] : enumerate(row)) {
-                if (not piece.isActive()) continue;
-
-                if (piece.isYellow() == yellowTurn()) // either both piece and turn are yellow, or both are black
-                    possible_moves.insert_range(
-                        possible_moves.cend(),
-                        piece.isPawn() ?
-                            generatePawnMoves(piece, {static_cast<int>(x), static_cast<int>(y)})
-                        : generateShaikhMoves(piece, {static_cast<int>(x), static_cast<int>(y)})
-                    );
-            }
-        }
-
-
-        if (std::ranges::any_of(possible_moves, [] (const auto& move) { return move.doesCapture(); })) {
-
-            // possible_moves = std::ranges::remove_if(possible_moves, [] (const auto& move) { return not move.doesCapture(); }) | std::ranges::to<std::vector<Move>>();
-            // possible_moves.erase(std::remove_if(possible_moves.begin(), possible_moves.end(), [] (const auto& move) { return not move.doesCapture(); }), possible_moves.cend());
-            // std::erase_if(std::begin(possible_moves), std::end(possible_moves), )
-            const auto max_captures = std::ranges::max_element(possible_moves, [] (const Move& m1, const Move& m2) { return m1.captures.size() < m2.captures.size(); })->captures.size();
-            std::erase_if(possible_moves, [max_captures] (const Move& move) { return move.captures.size() < max_captures; });
-        }
-    }
-
-    // AI shit
-
-    int evaluate() const noexcept {
-        int yellow_total{};
-        int black_total{};
-
-        for (size_t y{}; const auto& row : board) {
-
-            // const int b_dist_bias = std::max(0, y - 3) * 30;
-            // const int y_dist_bias = std::max(0, 4 - y) * 30;
-
-            const auto b_dist_bias = PROMOTION_DISTANCE[y].first ; // first  is black
-            const auto y_dist_bias = PROMOTION_DISTANCE[y].second; // second is black
-            // std::clog << "y(" << y << "):\n" << "black bias: " << b_dist_bias << "\nyello bias: " << y_dist_bias << '\n';.
-
-
-            for (const auto piece : row) {
-                if (not piece.isActive()) continue; // .value() will not count inactive pieces
-
-
-                if (piece.isYellow())   yellow_total += piece.value() + ((1 - piece.isShaikh()) * y_dist_bias); // don't want shaikhs to be tempted to go up
-                else /* must be black */ black_total += piece.value() + ((1 - piece.isShaikh()) * b_dist_bias); // only pawns need to push
-
-            }
-
-            ++y;
-        }
-
-
-        const int perspective = blackTurn() ? 1 : -1;
-        return perspective * (black_total - yellow_total);
-    }
-
-
-    void makeMove(const Piece piece, const Move& move) noexcept {
-        const auto [x, y] = move.positions.back();
-        get({x, y}) = piece;
-
-        if (y == 7 or y == 0 /* and not piece.isShaikh() */) get({x, y}).promote();
-
-        get(move.positions[0]).reset();
-
-        for (const auto& [_, pos] : move.captures) get(pos).reset();
-
-        nextTurn();
-    }
-
-    void unMakeMove(const Piece piece, const Move& move) noexcept {
-        get(move.positions[0]) = piece;
-        get(move.positions.back()).reset();
-
-        for (const auto& [captured_piece, pos] : move.captures) get(pos) = captured_piece;
-
-        nextTurn();
-    }
-
-
-    // int minimax(int depth) {
-    //     if (not depth) return evaluate();
-
-    //     // populates the "possible_moves" member
-    //     generateMoves();
-    //     if (possible_moves.empty()) return -INF;
-
-
-
-    //     const auto moves = std::move(possible_moves);
-    //     int best = -INF;
-    //     for (const auto& move : moves) {
-    //         const auto piece = get(move.positions[0]);
-    //         makeMove(piece, move);
-    //         const int eval = -minimax(depth - 1);
-    //         unMakeMove(piece, move);
-
-    //         if (eval > best) best = eval;
-    //     }
-
-    //     return best;
-    // }
-
-    int alphaBeta(int depth, int alpha = -INF, int beta = INF) {
-        // if (depth <= 0) return evaluate();
-        if (depth <= 0 and  (possible_moves.empty() or not possible_moves[0].doesCapture())) return evaluate();
-
-        generateMoves();
-
-        const auto moves = std::move(possible_moves);
-        if (moves.empty()) return -INF;
-
-
-        // // basically saying if we reached the depth, but we're in a capturing position
-        // // keep going. Untill there is no captures left!
-        // if (depth <= 0 and not moves[0].doesCapture()) return evaluate();
-
-
-
-        for (const auto& move : moves) {
-            const auto piece = get(move.positions[0]);
-
-            makeMove(piece, move);
-            const int eval = -alphaBeta(depth - 1, -beta, -alpha);
-            unMakeMove(piece, move);
-
-            // if move is too good
-            if (eval >= beta) return beta; // prune the brach!
-            if (eval > alpha) alpha = eval;
-
+        if (dragging) {
+            const auto [x, y] = sf::Mouse::getPosition(window);
+            renderer.piece(dragging, {static_cast<float>(x), static_cast<float>(y)});
         }
-
-        return alpha;
     }
 
+    bool isDragging() const noexcept { return dragging; }
 
-    Move bestMove() {
-        generateMoves(); // populates possible_moves;
-
-        const auto moves = std::move(possible_moves);
-
-        Move best_move;
-        int best_score = std::numeric_limits<int>::min();
-        for (const auto& move : moves) {
-            const auto piece = get(move.positions[0]);
-            makeMove(piece, move);
-            const auto score = -alphaBeta(4);
-            unMakeMove(piece, move);
-
-            if (score >= best_score) {
-                best_score = score;
-                best_move  =  move;
-            }
-        }
-
-        // std::clog << (yellowTurn() ? "yellow's score: " : "black's score: ") << best_score << '\n';
-        return best_move;
-    }
-
+    // whether whoever's turn it is has any move, or the rest of one mid capture
+    bool canMove() const noexcept { return not possible_moves.empty(); }
 
 
 private:
@@ -680,18 +251,18 @@ public:
         AI_highlighs.positions.push_back(move.positions[AI_inflight_idx + 1]);
 
         const auto piece = get(move.positions[AI_inflight_idx]);
-        get(move.positions[AI_inflight_idx]).reset();
+        reset(move.positions[AI_inflight_idx]);
         const auto to = move.positions[AI_inflight_idx + 1];
-        get(to) = piece;
+        set(to, piece);
 
-        if (not get(to).isShaikh() and (to.y == 7 or to.y == 0)) {
-            get(to).promote();
+        if (not piece.isShaikh() and (to.y == 7 or to.y == 0)) {
+            promote(to);
             sfx = SoundFX::PROMOTE;
         }
 
         if (move.doesCapture()) {
             AI_highlighs.captures.push_back(move.captures[AI_inflight_idx]);
-            get(move.captures[AI_inflight_idx].pos).reset();
+            reset(move.captures[AI_inflight_idx].pos);
 
             if (sfx != SoundFX::PROMOTE) sfx = SoundFX::CAPTURE;
         }
@@ -713,92 +284,6 @@ public:
     bool AIInflight() const noexcept { return AI_inflight_idx != 0; }
 
 
-    // 
-    void parseFen(const std::string_view fen) noexcept {
-        for(size_t x{}, y{}; char c : fen){
-            switch(c){
-                case 'y':
-                    // pieces[index] = Piece{{x, y}, Piece::Color::YELLOW, false};
-                    // board[y][x] = Piece{{x, y}, Piece::Color::YELLOW, false};
-                    board[y][x] = Piece::Flags::ACTIVE | Piece::Flags::YELLOW;
-
-                    ++x;
-                    break;
-                case 'Y':
-                    // pieces[index] = Piece{{x, y}, Piece::Color::YELLOW, true};
-                    // board[y][x] = Piece{{x, y}, Piece::Color::YELLOW, true};
-                    board[y][x] = Piece::Flags::ACTIVE | Piece::Flags::YELLOW | Piece::Flags::SHAIKH;
-                    ++x;
-                    break;
-                case 'b':
-                    // pieces[index] = Piece{{x, y}, Piece::Color::BLACK, false};
-                    // board[y][x] = Piece{{x, y}, Piece::Color::BLACK, false};
-                    board[y][x] = Piece::Flags::ACTIVE; // active assumed to be black pawn
-                    ++x;
-                    break;
-                case 'B':
-                    // pieces[index] = Piece{{x, y}, Piece::Color::BLACK, true};
-                    // board[y][x] = Piece{{x, y}, Piece::Color::BLACK, true};
-                    board[y][x] = Piece::Flags::ACTIVE | Piece::Flags::SHAIKH;
-                    ++x;
-                    break;
-                case '/':
-                    ++y;
-                    x = 0;
-                    break;
-                default:
-                    x += size_t(c - '0');
-                    break;
-            }
-        }
-    }
-
-    void prettyPrint() const {
-        std::clog << "==================\n";
-
-        for (const auto& row : board) {
-            for (const auto piece : row) {
-                piece.prettyPrint();
-            }
-            std::clog << '\n';
-        }
-
-        std::clog << "==================\n";
-    }
-
-    static void printMoves(const std::vector<Move>& moves) {
-        for (auto&& [idx, move] : enumerate(moves)) {
-            std::clog << '[' << idx << "]: ";
-            move.prettyPrint();
-        }
-    }
-
-
-    std::string fen() const {
-        std::string out;
-
-        for (size_t count; const auto& row : board) {
-            count = 0;
-            for (const auto& piece : row) {
-                if (piece) {
-                    if (count) out += std::to_string(count);
-
-                    count = 0;
-                    out += char(piece);
-                }
-                else ++count;
-            }
-
-            if (count) out += std::to_string(count);
-
-            out += '/';
-        }
-
-        out.pop_back();
-        return out;
-    }
-
-
     enum class SoundFX { MOVE, CAPTURE, PROMOTE };
 
     static void play(SoundFX fx) {
@@ -4,10 +4,12 @@
 #include <utility>
 #include <iterator>
 #include <type_traits>
+#include <cstdint>
 
 #include "helper.hxx"
 #include "Position.hxx"
 #include "Piece.hxx"
+#include "Bitboard.hxx"
 
 template <typename T, size_t N>
 class static_vector {
@@ -52,6 +54,19 @@ public:
 
 struct CapturedPiece { Piece piece; /* char padding[7]; */ Position pos; }; // 16 bytes. could 12 be better?
 
+
+// what the search works with instead of Move. Making and unmaking a move only needs where it starts, where it ends
+// and what it took, so the path in between is left out. 16 bytes, a Move is several hundred
+struct CompactMove {
+    std::uint8_t from{}, to{}; // squares, see Bitboard.hxx
+    Bitboard captures{};
+
+    constexpr bool doesCapture() const noexcept { return captures; }
+    constexpr size_t captureCount() const noexcept { return size_t(popCount(captures)); }
+
+    bool operator==(const CompactMove&) const noexcept = default;
+};
+
 struct Move {
     static_vector<Position, 16> positions;
     static_vector<CapturedPiece, 16> captures;
@@ -59,6 +74,7 @@ struct Move {
 
     constexpr bool isValid() const noexcept { return positions.size(); }
     constexpr bool doesCapture() const noexcept { return  captures.size(); }
+    constexpr size_t captureCount() const noexcept { return captures.size(); }
     constexpr void clear() noexcept {
         positions.clear();
         captures.clear();
@@ -67,6 +83,12 @@ struct Move {
 
     explicit constexpr operator bool() const noexcept { return isValid(); }
 
+    constexpr CompactMove compact() const noexcept {
+        CompactMove move{static_cast<std::uint8_t>(squareOf(positions[0])), static_cast<std::uint8_t>(squareOf(positions.back()))};
+        for (const auto& capture : captures) move.captures |= squareBit(capture.pos);
+        return move;
+    }
+
     void prettyPrint() const {
         for (const auto pos : positions)
             std::clog << '{' << pos.x << ", " << pos.y << "} -> ";
@@ -4,22 +4,9 @@
 #include <iostream>
 #include <type_traits>
 
-#include <SFML/Graphics.hpp>
-
 #include "Position.hxx"
 
 
-#define ASSETS_PATH "src/assets/"
-#define  FONTS_PATH ASSETS_PATH "fonts/"
-#define IMAGES_PATH ASSETS_PATH "images/"
-#define SOUNDS_PATH ASSETS_PATH "sfx/"
-
-
-constexpr sf::Color AWAY_COLOR  = {32, 20 ,  0};
-constexpr sf::Color HOME_COLOR  = {204, 126, 0};
-// constexpr sf::Color CROWN_COLOR = 
-
-
 struct Piece {
     // assume black, undragged, pawn if active
     enum class Flags : unsigned char {
@@ -62,63 +49,6 @@ struct Piece {
     }
 
 
-    sf::CircleShape getShape(sf::RenderWindow& window, const sf::Vector2f pos, const bool dragging = false) const {
-        const auto winsize = window.getSize();
-        const float radius = winsize.x / 20; // / 10 / 2
-
-        sf::CircleShape circle{radius};
-        //  32, 20, 0
-        circle.setFillColor(isYellow() ? HOME_COLOR : AWAY_COLOR);
-        circle.setOrigin({radius, radius});
-
-
-        if (dragging) circle.setPosition(pos);
-        else {
-            const float block_size = winsize.x / 8;
-            const float half_block_size = winsize.x / 16;
-            circle.setPosition({pos.x * block_size + half_block_size, pos.y * block_size + half_block_size});
-        }
-
-        return circle;
-    }
-
-    void render(sf::RenderWindow& window, sf::Vector2f pos, const bool dragging = false) const {
-        // std::clog << "is active? " << (isActive() ? "yes\n" : "no\n");
-        // std::println(std::clog, "{:b}", int(flags));
-        if (not isActive()) return;
-
-        const auto circle = getShape(window, pos, dragging);
-
-        window.draw(circle);
-
-        if (isShaikh()) {
-
-            if (dragging) {
-                crown.setPosition(pos);
-            }
-            else {
-                const auto winsize = window.getSize();
-                const float block_size = winsize.x / 8;
-                const float half_block_size = winsize.x / 16;
-                crown.setPosition({pos.x * block_size + half_block_size, pos.y * block_size + half_block_size});
-            }
-
-            window.draw(crown);
-        }
-    }
-
-
-    // Crown can be static but not circle is because circle technically depends on the size of the window!
-    [[clang::no_destroy]] const static inline sf::Texture CROWN_IMAGE{IMAGES_PATH "crown_brown.png", false, sf::IntRect{{0, 0}, {512, 512}}};
-    static inline sf::Sprite crown = [] {
-        sf::Sprite crown{CROWN_IMAGE};
-        crown.setOrigin({256, 256});
-        crown.setScale({.1f, .1f});
-        return crown;
-    }();
-
-
-
     // constexpr operator char() const noexcept {
     //     if (isActive()) {
     //         if (isYellow()) return isShaikh() ? 'Y' : 'y';
@@ -127,16 +57,15 @@ struct Piece {
     //     else return ' ';
     // }
 
+    // the letter fens use for it. Not an operator char, that one fights with operator bool
+    constexpr char symbol() const noexcept {
+        if (not isActive()) return ' ';
+        if (isYellow()) return isShaikh() ? 'Y' : 'y';
+        return isShaikh() ? 'B' : 'b';
+    }
+
     void prettyPrint() const {
-        if (not isActive()) {
-            std::clog << ' ';
-        }
-        else if (isYellow()) {
-            std::clog << (isShaikh() ? 'Y' : 'y');
-        }
-        else {
-            std::clog << (isShaikh() ? 'B' : 'b');
-        }
+        std::clog << symbol();
     }
 
 
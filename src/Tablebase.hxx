@@ -0,0 +1,279 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <span>
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <optional>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+#include <cstdint>
+#include <cstring>
+
+#if __has_include(<sys/mman.h>)
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define DAMA_HAS_MMAP 1
+#endif
+
+#include "Bitboard.hxx"
+#include "helper.hxx"
+
+
+// what a known position scores. Above anything evaluate() comes up with, below INF
+constexpr auto TABLEBASE_WIN = 50000;
+
+// no table has more pieces than this. Anything past 4 is huge anyway
+constexpr auto TABLEBASE_MAX_PIECES = 7;
+
+
+// one byte per position. 0 is a draw (or a position that can't happen), anything else is plies + 1 until the winning
+// side converts, meaning it captures or promotes into a smaller table it still wins in. Odd plies the side to move wins
+constexpr std::uint8_t tablebaseValue(const int plies) noexcept { return static_cast<std::uint8_t>(plies + 1); }
+constexpr int tablebasePlies(const std::uint8_t value) noexcept { return value - 1; }
+constexpr bool tablebaseWin(const std::uint8_t value) noexcept { return value and tablebasePlies(value) % 2; }
+
+// sooner wins score higher, so the search heads for them
+constexpr int tablebaseScore(const std::uint8_t value) noexcept {
+    if (not value) return 0;
+    return tablebaseWin(value) ? TABLEBASE_WIN - tablebasePlies(value) : tablebasePlies(value) - TABLEBASE_WIN;
+}
+
+
+// how many of each kind of piece are on the board. Every combination gets its own table
+struct Material {
+    int yellow_pawns{}, yellow_shaikhs{}, black_pawns{}, black_shaikhs{};
+
+    constexpr static Material of(const Bitboard yellow, const Bitboard black, const Bitboard shaikhs) noexcept {
+        return {popCount(yellow & ~shaikhs), popCount(yellow & shaikhs), popCount(black & ~shaikhs), popCount(black & shaikhs)};
+    }
+
+    constexpr int pieces() const noexcept { return yellow_pawns + yellow_shaikhs + black_pawns + black_shaikhs; }
+    constexpr int  pawns() const noexcept { return yellow_pawns + black_pawns; }
+
+    // where its table goes in Tablebase::tables
+    constexpr size_t slot() const noexcept {
+        return size_t(((yellow_pawns * 8 + yellow_shaikhs) * 8 + black_pawns) * 8 + black_shaikhs);
+    }
+
+    // "1Y0y1B1b" is a yellow shaikh against a black shaikh and pawn. Every count is in there so
+    // case insensitive file systems can still tell them apart
+    std::string name() const {
+        return std::to_string(yellow_shaikhs) + 'Y' + std::to_string(yellow_pawns) + 'y'
+             + std::to_string( black_shaikhs) + 'B' + std::to_string( black_pawns) + 'b';
+    }
+
+    constexpr bool operator==(const Material&) const noexcept = default;
+};
+
+
+// what a table index stands for. Pieces of different kinds may share a square, those indices are never probed
+struct TablebasePosition {
+    Bitboard yellow{}, black{}, shaikhs{};
+    bool yellow_turn{};
+};
+
+
+// C(n, k), the number of ways to put k identical pieces on n squares
+consteval auto precomputeBinomials() {
+    std::array<std::array<std::uint64_t, TABLEBASE_MAX_PIECES + 1>, 65> data{};
+
+    for (const auto n : range(65uz)) {
+        data[n][0] = 1;
+        for (const auto k : range(1uz, TABLEBASE_MAX_PIECES + 1uz)) data[n][k] = n ? data[n - 1][k - 1] + data[n - 1][k] : 0;
+    }
+
+    return data;
+}
+
+constexpr inline auto BINOMIALS = precomputeBinomials();
+
+
+// every table found in a directory, mapped once at startup and never written after. Probing only reads,
+// so any number of search threads can share one without locking
+class Tablebase {
+    // read only view of a whole file. Mapped where there is mmap, so the OS only pages in what probes touch and
+    // processes using the same tables share the memory. Elsewhere it's just read in
+    class MappedFile {
+        std::span<const std::uint8_t> bytes;
+    #ifndef DAMA_HAS_MMAP
+        std::vector<std::uint8_t> buffer;
+    #endif
+
+    public:
+        explicit MappedFile(const std::filesystem::path& path) {
+        #ifdef DAMA_HAS_MMAP
+            const auto fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) return;
+
+            if (const auto size = size_t(::lseek(fd, 0, SEEK_END)); size and size != size_t(-1)) {
+                if (const auto data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0); data != MAP_FAILED)
+                    bytes = {static_cast<const std::uint8_t*>(data), size};
+            }
+
+            ::close(fd); // the mapping keeps the file around
+        #else
+            std::ifstream file{path, std::ios::binary};
+            buffer.assign(std::istreambuf_iterator<char>{file}, {});
+            bytes = buffer;
+        #endif
+        }
+
+        ~MappedFile() {
+        #ifdef DAMA_HAS_MMAP
+            if (not bytes.empty()) ::munmap(const_cast<std::uint8_t*>(bytes.data()), bytes.size());
+        #endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept
+        : bytes{std::exchange(other.bytes, {})}
+    #ifndef DAMA_HAS_MMAP
+        , buffer{std::move(other.buffer)}
+    #endif
+        {}
+
+        MappedFile& operator=(MappedFile&&) = delete;
+
+        std::span<const std::uint8_t> data() const noexcept { return bytes; }
+    };
+
+
+    std::vector<MappedFile> files;
+    std::array<std::span<const std::uint8_t>, 8 * 8 * 8 * 8> tables{};
+    int max_pieces{};
+
+
+    // which of all the same sized sets of squares `bits` is, counting in order (the combinatorial number system)
+    constexpr static std::uint64_t rankSquares(Bitboard bits) noexcept {
+        std::uint64_t rank{};
+        for (size_t k = 1; bits; ++k) rank += BINOMIALS[size_t(popFirst(bits))][k];
+        return rank;
+    }
+
+    constexpr static Bitboard unrankSquares(std::uint64_t rank, const int count) noexcept {
+        Bitboard bits{};
+        for (auto k = size_t(count), square = 64uz; k; --k) {
+            do --square; while (BINOMIALS[square][k] > rank);
+
+            bits |= squareBit(int(square));
+            rank -= BINOMIALS[square][k];
+        }
+        return bits;
+    }
+
+public:
+    // 16 bytes in front of every table file, then size() values in index order
+    struct Header {
+        std::array<char, 8> magic = MAGIC;
+        std::array<std::uint8_t, 4> material{}; // yellow pawns, yellow shaikhs, black pawns, black shaikhs
+        std::uint32_t reserved{};
+    };
+
+    constexpr static std::array<char, 8> MAGIC = {'D', 'A', 'M', 'A', 'T', 'B', '0', '1'};
+    constexpr static std::string_view EXTENSION = ".dtb";
+
+
+    Tablebase() = default;
+
+    // maps every table file in `directory`. A missing directory is just an empty tablebase
+    explicit Tablebase(const std::filesystem::path& directory) {
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator{directory, error}) {
+            if (entry.path().extension() == EXTENSION) load(entry.path());
+        }
+    }
+
+    Tablebase(const Tablebase&) = delete;
+    Tablebase& operator=(const Tablebase&) = delete;
+
+
+    // false if the file isn't a table, or is cut short
+    bool load(const std::filesystem::path& path) {
+        MappedFile file{path};
+        const auto bytes = file.data();
+
+        Header header;
+        if (bytes.size() < sizeof(Header)) return false;
+        std::memcpy(&header, bytes.data(), sizeof(Header));
+
+        const Material material{header.material[0], header.material[1], header.material[2], header.material[3]};
+        if (
+               header.magic != MAGIC
+            or material.pieces() > TABLEBASE_MAX_PIECES
+            or bytes.size() != sizeof(Header) + size(material)
+        ) return false;
+
+        tables[material.slot()] = bytes.subspan(sizeof(Header));
+        max_pieces = std::max(max_pieces, material.pieces());
+
+        files.push_back(std::move(file));
+        return true;
+    }
+
+    int maxPieces() const noexcept { return max_pieces; }
+    bool has(const Material material) const noexcept { return not tables[material.slot()].empty(); }
+
+
+    // two entries for every way to place the pieces, one for each side to move
+    constexpr static size_t size(const Material material) noexcept {
+        return 2 * BINOMIALS[64][size_t(material.yellow_pawns)] * BINOMIALS[64][size_t(material.yellow_shaikhs)]
+                 * BINOMIALS[64][size_t(material.black_pawns )] * BINOMIALS[64][size_t(material.black_shaikhs )];
+    }
+
+    constexpr static size_t index(const Material material, const Bitboard yellow, const Bitboard black, const Bitboard shaikhs, const bool yellow_turn) noexcept {
+        auto index = rankSquares(yellow & ~shaikhs);
+        index = index * BINOMIALS[64][size_t(material.yellow_shaikhs)] + rankSquares(yellow & shaikhs);
+        index = index * BINOMIALS[64][size_t(material.black_pawns   )] + rankSquares(black  & ~shaikhs);
+        index = index * BINOMIALS[64][size_t(material.black_shaikhs )] + rankSquares(black  & shaikhs);
+        return 2 * index + (yellow_turn ? 0 : 1);
+    }
+
+    // the other way around, for the generator
+    constexpr static TablebasePosition position(const Material material, size_t index) noexcept {
+        TablebasePosition out{.yellow_turn = index % 2 == 0};
+        index /= 2;
+
+        const auto next = [&index] (const int count) {
+            const auto combinations = BINOMIALS[64][size_t(count)];
+            const auto bits = unrankSquares(index % combinations, count);
+            index /= combinations;
+            return bits;
+        };
+
+        // last in, first out
+        const auto black_shaikhs  = next(material.black_shaikhs);
+        const auto black_pawns    = next(material.black_pawns);
+        const auto yellow_shaikhs = next(material.yellow_shaikhs);
+        const auto yellow_pawns   = next(material.yellow_pawns);
+
+        out.yellow  = yellow_pawns | yellow_shaikhs;
+        out.black   = black_pawns  | black_shaikhs;
+        out.shaikhs = yellow_shaikhs | black_shaikhs;
+        return out;
+    }
+
+
+    // the raw table value, if there's a table for this many pieces
+    std::optional<std::uint8_t> value(const Bitboard yellow, const Bitboard black, const Bitboard shaikhs, const bool yellow_turn) const noexcept {
+        if (popCount(yellow | black) > max_pieces) return std::nullopt;
+
+        const auto material = Material::of(yellow, black, shaikhs);
+        const auto table = tables[material.slot()];
+        if (table.empty()) return std::nullopt;
+
+        return table[index(material, yellow, black, shaikhs, yellow_turn)];
+    }
+
+    // the exact score for the side to move
+    std::optional<int> probe(const Bitboard yellow, const Bitboard black, const Bitboard shaikhs, const bool yellow_turn) const noexcept {
+        if (const auto known = value(yellow, black, shaikhs, yellow_turn)) return tablebaseScore(*known);
+        return std::nullopt;
+    }
+};
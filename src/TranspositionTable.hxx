@@ -0,0 +1,98 @@
+#pragma once
+
+#include <vector>
+#include <optional>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+
+
+// what a stored score means. Searches that got cut off only know one side of the true score
+enum class Bound : std::uint8_t {
+    NONE,
+    EXACT,
+    LOWER, // failed high, the score is at least this
+    UPPER, // failed low, the score is at most this
+};
+
+
+struct TTEntry {
+    std::uint64_t key{};
+    std::int32_t score{};
+    std::int8_t depth{};
+    Bound bound = Bound::NONE;
+    std::uint16_t move{}; // index into the position's generated moves. Generation is deterministic so it's the same list next time
+};
+
+
+// fixed size hash table of searched positions, indexed by the low bits of the zobrist hash.
+// Safe to share between searching threads without locks, see Slot
+class TranspositionTable {
+    // the key is stored xor-ed with the data. If two threads write the same slot at once and the words end up from
+    // different entries, the key won't xor back to anything anyone probes for, so a torn entry just looks like a miss
+    struct Slot {
+        std::atomic<std::uint64_t> check{};
+        std::atomic<std::uint64_t> data{};
+    };
+
+    static_assert(sizeof(Slot) == 16);
+
+    std::vector<Slot> slots;
+    std::uint64_t mask;
+
+
+    constexpr static std::uint64_t pack(const TTEntry entry) noexcept {
+        return std::uint64_t{static_cast<std::uint32_t>(entry.score)}
+             | std::uint64_t{static_cast<std::uint8_t>(entry.depth)} << 32
+             | std::uint64_t{static_cast<std::uint8_t>(entry.bound)} << 40
+             | std::uint64_t{entry.move}                             << 48;
+    }
+
+    constexpr static TTEntry unpack(const std::uint64_t key, const std::uint64_t data) noexcept {
+        return {
+            key,
+            static_cast<std::int32_t>(static_cast<std::uint32_t>(data)),
+            static_cast<std::int8_t>(static_cast<std::uint8_t>(data >> 32)),
+            static_cast<Bound>(static_cast<std::uint8_t>(data >> 40)),
+            static_cast<std::uint16_t>(data >> 48),
+        };
+    }
+
+public:
+    explicit TranspositionTable(const size_t megabytes = 16)
+    : slots(std::bit_floor(megabytes * 1024 * 1024 / sizeof(Slot)))
+    , mask{slots.size() - 1}
+    {}
+
+
+    std::optional<TTEntry> probe(const std::uint64_t key) const noexcept {
+        const auto& slot = slots[key & mask];
+        const auto data = slot.data.load(std::memory_order_relaxed);
+        if ((slot.check.load(std::memory_order_relaxed) ^ data) != key) return std::nullopt;
+
+        const auto entry = unpack(key, data);
+        if (entry.bound == Bound::NONE) return std::nullopt;
+
+        return entry;
+    }
+
+    void store(const std::uint64_t key, const int depth, const int score, const Bound bound, const size_t move) noexcept {
+        auto& slot = slots[key & mask];
+
+        // a deeper result for the same position is worth more. Anything else gets replaced
+        const auto old_data = slot.data.load(std::memory_order_relaxed);
+        if ((slot.check.load(std::memory_order_relaxed) ^ old_data) == key and unpack(key, old_data).depth > depth) return;
+
+        const auto data = pack({key, score, static_cast<std::int8_t>(depth), bound, static_cast<std::uint16_t>(move)});
+        slot.check.store(key ^ data, std::memory_order_relaxed);
+        slot.data .store(data,       std::memory_order_relaxed);
+    }
+
+    void clear() noexcept {
+        for (auto& slot : slots) {
+            slot.check.store(0, std::memory_order_relaxed);
+            slot.data .store(0, std::memory_order_relaxed);
+        }
+    }
+};
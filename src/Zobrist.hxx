@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+#include "Piece.hxx"
+
+
+consteval std::uint64_t splitMix64(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+    return z ^ (z >> 31);
+}
+
+
+// a position's hash is all of its keys xor-ed together, so a move only has to xor in and out what it touched
+struct ZobristKeys {
+    std::array<std::array<std::uint64_t, 64>, 4> pieces{}; // kind (see zobristKind), then square
+    std::uint64_t black_turn{};
+};
+
+consteval auto precomputeZobristKeys() {
+    ZobristKeys keys;
+
+    std::uint64_t state = 0x0DA3A0DA3A0DA3A0; // any seed works, it just has to stay the same between builds
+    for (auto& kind : keys.pieces) for (auto& key : kind) key = splitMix64(state);
+    keys.black_turn = splitMix64(state);
+
+    return keys;
+}
+
+constexpr inline auto ZOBRIST = precomputeZobristKeys();
+
+
+// yellow pawn, yellow shaikh, black pawn, black shaikh
+constexpr size_t zobristKind(const Piece piece) noexcept { return (piece.isYellow() ? 0 : 2) + (piece.isShaikh() ? 1 : 0); }
+
+constexpr std::uint64_t zobristKey(const Piece piece, const int square) noexcept { return ZOBRIST.pieces[zobristKind(piece)][size_t(square)]; }
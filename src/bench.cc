@@ -0,0 +1,215 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <string_view>
+#include <array>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <memory>
+#include <cstdlib>
+
+#include "Board.hxx"
+
+
+// headless perft and search timings, so move generation and speed can be checked without a window
+//
+// usage: dama_bench [perft depth = 6] [search depth = 10] [max threads = all cores] [tablebases = tablebases]
+
+
+struct BenchPosition {
+    std::string_view name;
+    std::string_view fen;
+    bool yellow_starts = true;
+
+    // known perft results by depth, index 0 is depth 1. Deeper runs aren't checked
+    std::array<size_t, 6> perft{};
+};
+
+
+// the test positions from main.cc, plus the opening
+constexpr std::array BENCH_POSITIONS = {
+    BenchPosition{"start",            "8/bbbbbbbb/bbbbbbbb/8/8/yyyyyyyy/yyyyyyyy/8",  true, {8, 64, 708, 7538, 85090, 931312}},
+    BenchPosition{"promotion stop",   "5B2/6b1/8/6b1/6y1/8/8/8",                      true, {1, 1, 0, 0, 0, 0}},
+    BenchPosition{"longest capture",  "8/8/8/3b4/5b2/8/yb1b1Y2/8",                    true, {1, 3, 36, 91, 957, 4698}},
+    BenchPosition{"multiple inflight","8/6b1/5b2/3b4/5b2/8/yb1b1Y2/8",                true, {2, 17, 181, 1566, 16039, 157409}},
+    BenchPosition{"cool position",    "Y4Y1Y/8/1bbbbbbb/1bbb3b/1b4b1/4b3/2yyyyyy/8",  true, {6, 54, 1045, 16068, 259915, 3970879}},
+    BenchPosition{"lone pawn",        "8/3b4/3b4/8/8/3y4/8/8",                        true, {3, 15, 43, 242, 690, 3360}},
+};
+
+
+// few pieces, for comparing the search with and without the tablebase. Needs 3 piece tables. Named like the
+// table files, see Material::name()
+constexpr std::array ENDGAME_POSITIONS = {
+    BenchPosition{"2Y0y0B1b", "8/8/2b5/8/8/8/8/Y6Y"},
+    BenchPosition{"1Y1y0B1b", "8/1b6/8/8/8/8/4y3/Y7"},
+    BenchPosition{"1Y1y1B0b", "8/8/2B5/8/8/8/4y3/Y7"},
+};
+
+
+static double secondsSince(const std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static double perSecond(const size_t count, const double seconds) {
+    return seconds > 0 ? static_cast<double>(count) / seconds : 0;
+}
+
+
+int main(int argc, char** argv) {
+    const int perft_depth  = argc > 1 ? std::atoi(argv[1]) : 6;
+    const int search_depth = argc > 2 ? std::atoi(argv[2]) : 10;
+    const int max_threads  = argc > 3 ? std::atoi(argv[3]) : int(std::max(1u, std::thread::hardware_concurrency()));
+    const auto tablebase = std::make_shared<const Tablebase>(argc > 4 ? argv[4] : "tablebases");
+
+    // fixed depth, so runs are comparable. The time limit is only there so nothing hangs
+    const SearchLimits limits{.depth = search_depth, .time = std::chrono::minutes{10}};
+
+    bool failed = false;
+
+    std::cout << std::fixed << std::setprecision(3);
+
+
+    std::cout << "perft " << perft_depth << '\n';
+
+    size_t total_leaves{};
+    double total_seconds{};
+    for (const auto& position : BENCH_POSITIONS) {
+        Board board{position.fen, position.yellow_starts};
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto leaves = board.perft(perft_depth);
+        const auto seconds = secondsSince(start);
+
+        total_leaves  += leaves;
+        total_seconds += seconds;
+
+        const bool known = perft_depth >= 1 and size_t(perft_depth) <= position.perft.size();
+        const auto expected = known ? position.perft[size_t(perft_depth - 1)] : 0;
+        const bool ok = not known or expected == leaves;
+        failed = failed or not ok;
+
+        std::cout
+            << "  " << std::left  << std::setw(18) << position.name
+            << std::right << std::setw(14) << leaves << " leaves "
+            << std::setw(10) << seconds << "s "
+            << std::setw(14) << std::setprecision(0) << perSecond(leaves, seconds) << " leaves/s" << std::setprecision(3)
+            << (not known ? "" : ok ? "  ok" : "  MISMATCH, expected " + std::to_string(expected))
+            << '\n';
+    }
+
+    std::cout << "  total " << total_leaves << " leaves in " << total_seconds << "s, "
+              << std::setprecision(0) << perSecond(total_leaves, total_seconds) << " leaves/s\n\n" << std::setprecision(3);
+
+
+    std::cout << "bestMove, depth " << search_depth << '\n';
+
+    size_t total_nodes{};
+    total_seconds = 0;
+    for (const auto& position : BENCH_POSITIONS) {
+        Board board{position.fen, position.yellow_starts};
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto move = board.bestMove(limits);
+        const auto seconds = secondsSince(start);
+
+        total_nodes   += board.nodes;
+        total_seconds += seconds;
+
+        std::cout
+            << "  " << std::left  << std::setw(18) << position.name
+            << std::right << std::setw(14) << board.nodes << " nodes  "
+            << std::setw(10) << seconds << "s "
+            << std::setw(14) << std::setprecision(0) << perSecond(board.nodes, seconds) << " nodes/s  " << std::setprecision(3);
+
+        if (move) {
+            const auto [from_x, from_y] = move.positions[0];
+            const auto [to_x, to_y] = move.positions.back();
+            std::cout << char('A' + from_x) << 8 - from_y << " -> " << char('A' + to_x) << 8 - to_y;
+        }
+        else std::cout << "no move";
+
+        std::cout << '\n';
+    }
+
+    std::cout << "  total " << total_nodes << " nodes in " << total_seconds << "s, "
+              << std::setprecision(0) << perSecond(total_nodes, total_seconds) << " nodes/s\n\n" << std::setprecision(3);
+
+
+    // same searches again with more threads. Each run starts with an empty table so none of them gets a head start
+    std::cout << "threads, depth " << search_depth << '\n';
+
+    double serial_seconds{};
+    std::array<Move, BENCH_POSITIONS.size()> serial_moves;
+    for (int threads = 1; threads <= max_threads; threads = threads < max_threads ? std::min(threads * 2, max_threads) : threads + 1) {
+        size_t nodes{};
+        double seconds{};
+        size_t different{}; // positions where the answer isn't the one thread answer. Fine for more threads, a bug for one
+
+        for (const auto& [i, position] : enumerate(BENCH_POSITIONS)) {
+            Board board{position.fen, position.yellow_starts};
+
+            SearchLimits threaded_limits = limits;
+            threaded_limits.threads = threads;
+
+            const auto start = std::chrono::steady_clock::now();
+            const auto move = board.bestMove(threaded_limits);
+            seconds += secondsSince(start);
+            nodes   += board.nodes;
+
+            if (threads == 1) serial_moves[i] = move;
+            else if (move.positions.back() != serial_moves[i].positions.back() or move.positions[0] != serial_moves[i].positions[0]) ++different;
+        }
+
+        if (threads == 1) serial_seconds = seconds;
+
+        std::cout
+            << "  " << std::setw(3) << threads << " threads "
+            << std::setw(10) << seconds << "s "
+            << std::setw(14) << nodes << " nodes "
+            << std::setw(14) << std::setprecision(0) << perSecond(nodes, seconds) << " nodes/s " << std::setprecision(2)
+            << std::setw(6) << (seconds > 0 ? serial_seconds / seconds : 0) << "x speedup  "
+            << different << " different moves"
+            << std::setprecision(3) << '\n';
+    }
+
+
+    if (tablebase->maxPieces() == 0) {
+        std::cout << "\nno tablebases, run dama_tbgen first\n";
+        return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    std::cout << "\ntablebase, depth " << search_depth << '\n';
+
+    for (const auto& position : ENDGAME_POSITIONS) {
+        for (const bool probing : {false, true}) {
+            Board board{position.fen, position.yellow_starts};
+            if (probing) board.setTablebase(tablebase);
+
+            const auto start = std::chrono::steady_clock::now();
+            board.bestMove(limits);
+            const auto seconds = secondsSince(start);
+
+            std::cout
+                << "  " << std::left << std::setw(18) << position.name << (probing ? " probing" : "        ")
+                << std::right << std::setw(14) << board.nodes << " nodes "
+                << std::setw(10) << seconds << "s\n";
+        }
+    }
+
+    // the same position over and over, so it's how long a lookup takes once the page is in memory
+    Board endgame{ENDGAME_POSITIONS[0].fen};
+    endgame.setTablebase(tablebase);
+
+    constexpr size_t PROBES = 1'000'000;
+    long long sum{};
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i{}; i < PROBES; ++i) sum += endgame.probeTablebase().value_or(0);
+    const auto seconds = secondsSince(start);
+
+    std::cout << "  " << std::setprecision(1) << seconds / PROBES * 1e9 << "ns per probe, score " << sum / static_cast<long long>(PROBES) << '\n';
+
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
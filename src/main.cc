@@ -1,189 +1,104 @@
 #include <SFML/Graphics.hpp>
 
 #include <print>
+#include <sstream>
+#include <iomanip>
 #include <cmath>
 #include <span>
 #include <chrono>
+#include <thread>
+#include <algorithm>
+#include <memory>
 
 #include "BoardState.hxx"
+#include "BoardRenderer.hxx"
+#include "AsyncSearch.hxx"
 #include "Move.hxx"
 #include "helper.hxx"
 
 
-constexpr sf::Color  DARK_TILE      = {107, 77 , 64 };
-constexpr sf::Color LIGHT_TILE      = {240, 201, 152};
+using std::chrono::operator""s;
+using std::chrono::operator""ms;
 
-constexpr sf::Color  DARK_HIGHLIGHT = {53 , 181, 87 };
-constexpr sf::Color LIGHT_HIGHLIGHT = {71 , 173, 98 };
+// how long the AI thinks on its turn, and on how many cores
+static const SearchLimits AI_LIMITS{.time = 2s, .threads = int(std::max(1u, std::thread::hardware_concurrency()))};
+constexpr auto HOP_DELAY = 500ms; // wait half a second between each hop of the AI's move to make it clear whats going on
 
-constexpr sf::Color   RED_HIGHLIGHT = {189, 60 , 0  };
-constexpr sf::Color  BLUE_HIGHLIGHT = {41 , 74 , 153};
+// made by dama_tbgen. Without them the AI just searches endgames like everything else
+constexpr auto TABLEBASES_PATH = "tablebases/";
 
+constexpr auto BLINKING_TIME = 500ms;
 
-[[clang::no_destroy]] static const sf::Font font{FONTS_PATH "Roboto-Regular.ttf"};
+// nothing changed, so nothing is drawn. Sleep about a frame instead, setFramerateLimit only sleeps in display()
+constexpr auto IDLE_WAIT = 1000ms / 144;
+
+constexpr auto STATS_INTERVAL = 1s; // on screen
+constexpr auto   LOG_INTERVAL = 5s; // std::clog
 
 
 template <bool AI = false>
-static void highlighMove(sf::RenderWindow& window, const Move& move, sf::RectangleShape& block , const sf::Vector2f block_size) {
+static void highlighMove(BoardRenderer& renderer, const Move& move) {
     if (not move) return;
 
-    sf::Text text{font, "", 18}; // text.setCharacterSize(18);
-
-    const auto [x_start, y_start] = move.positions[0];
-    block.setPosition({x_start * block_size.x, y_start * block_size.y});
-
-    if constexpr (AI) block.setFillColor(BLUE_HIGHLIGHT);
-    else              block.setFillColor( RED_HIGHLIGHT);
-
-    window.draw(block);
-
-    for (size_t step{1}; const auto [x, y] : move.positions | std::views::drop(1)) {
-        block.setPosition({x * block_size.x, y * block_size.y});
-        block.setFillColor((x + y) % 2 ? DARK_HIGHLIGHT : LIGHT_HIGHLIGHT);
-        window.draw(block);
+    renderer.square(move.positions[0], AI ? BLUE_HIGHLIGHT : RED_HIGHLIGHT);
 
+    for (int step{1}; const auto [x, y] : move.positions | std::views::drop(1)) {
+        renderer.square({x, y}, (x + y) % 2 ? DARK_HIGHLIGHT : LIGHT_HIGHLIGHT);
 
-        if constexpr (not AI) {
-            text.setString(std::to_string(step));
-
-            // shadow
-            text.setPosition({x * block_size.x + block_size.x - 20 + 2, y * block_size.y + 1 + 2});
-            text.setFillColor(sf::Color::Black);
-            window.draw(text);
-
-            // text
-            text.setPosition({x * block_size.x + block_size.x - 20    , y * block_size.y + 1    });
-            text.setFillColor(sf::Color::White);
-            window.draw(text);
-
-            ++step;
-        }
+        if constexpr (not AI) renderer.step({x, y}, step++);
     }
 
-    if constexpr (AI) {
-        const auto [x_end, y_end] = move.positions.back();
-        block.setPosition({x_end * block_size.x, y_end * block_size.y});
-        block.setFillColor(RED_HIGHLIGHT);
-        window.draw(block);
-    }
+    if constexpr (AI) renderer.square(move.positions.back(), RED_HIGHLIGHT);
 }
 
 static void highlight(
-    sf::RenderWindow& window,
+    BoardRenderer& renderer,
     const std::span<Move> moves, const std::span<Move> highlights, const Move& AI_highlight,
-    sf::RectangleShape& block  , const sf::Vector2f block_size
+    const bool blink_on
 ) {
-
-
     constexpr auto AI_MOVE = true;
-    highlighMove<AI_MOVE>(window, AI_highlight, block, block_size);
-
-    for (const auto& move : highlights) highlighMove(window, move, block, block_size);
-
-    if (highlights.empty() and not moves.empty()) {
-        using std::chrono::operator""s;
-
-        constexpr auto BLINKING_TIME = 0.5s;
-        static auto next_switch = std::chrono::steady_clock::now() + BLINKING_TIME;
-
-        if (const auto now = std::chrono::steady_clock::now(); now < next_switch) {
-            for (const auto& move : moves) {
-                if (not move.doesCapture()) continue;
-
-                auto [x, y] = move.positions[0];
-                block.setPosition({x * block_size.x, y * block_size.y});
-                block.setFillColor((x + y) % 2 ? DARK_HIGHLIGHT : LIGHT_HIGHLIGHT);
-                window.draw(block);
-            }
-        }
-        else if (now > next_switch + BLINKING_TIME) next_switch = std::chrono::steady_clock::now() + BLINKING_TIME;
-
-    }
-}
+    highlighMove<AI_MOVE>(renderer, AI_highlight);
 
+    for (const auto& move : highlights) highlighMove(renderer, move);
 
-static void numbering(sf::RenderWindow& window, const int x, const int y, const sf::Vector2f block_size) {
-    sf::Text text{font};
-    text.setCharacterSize(18);
+    // the pieces that have to capture blink until one of them is picked up
+    if (not blink_on) return;
 
-    if (y == 7) {
-        text.setString(char('A' + x));
+    for (const auto& move : moves) {
+        if (not move.doesCapture()) continue;
 
-        text.setPosition({x * block_size.x + block_size.x - 20 + 2, y * block_size.y + block_size.y - 25 + 2});
-        text.setFillColor(sf::Color::Black);
-        window.draw(text);
-
-        text.setPosition({x * block_size.x + block_size.x - 20, y * block_size.y + block_size.y - 25});
-        text.setFillColor(sf::Color::White);
-        window.draw(text);
-    }
-
-    if (x == 0) {
-        text.setString(std::to_string(8 - y));
-
-        text.setPosition({x * block_size.x + 5 + 2, y * block_size.y + 1 + 2});
-        text.setFillColor(sf::Color::Black);
-        window.draw(text);
-
-        text.setPosition({x * block_size.x + 5, y * block_size.y + 1});
-        text.setFillColor(sf::Color::White);
-        window.draw(text);
+        const auto [x, y] = move.positions[0];
+        renderer.square({x, y}, (x + y) % 2 ? DARK_HIGHLIGHT : LIGHT_HIGHLIGHT);
     }
 }
 
 
-static void background(sf::RenderWindow& window, const std::span<Move> moves, const std::span<Move> highlights, const Move& AI_highlights) {
-    const auto winsize = window.getSize();
-    // std::clog << "windo size - x: " << winsize.x << ", y: " << winsize.y << '\n';
-
-    const sf::Vector2f block_size{
-        static_cast<float>(winsize.x / 8),
-        static_cast<float>(winsize.y / 8)
-    };
-    // std::clog << "block size - x: " << block_size.x << ", y: " << block_size.y << '\n';
-
-
-    sf::RectangleShape block{block_size};
+// everything a frame is drawn from. The same key twice means the same picture, so it isn't drawn again
+struct FrameKey {
+    std::uint64_t hash{};
+    size_t moves{}, highlights{}, AI_hops{};
+    bool blink_on{};
+    bool dragging{};
+    sf::Vector2i mouse; // only while dragging
 
-    for (bool flag{}; auto y : range(8)) {
-        for (auto x : range(8)) {
-            block.setPosition({x * block_size.x, y * block_size.y});
-            //  : sf::Color
-            block.setFillColor(flag ? LIGHT_TILE : DARK_TILE);
+    bool operator==(const FrameKey&) const noexcept = default;
+};
 
-            window.draw(block);
 
-            flag =! flag;
-        }
+// how much the drawing costs over some stretch of time
+struct FrameStats {
+    size_t loops{}, frames{}, draw_calls{};
+    std::chrono::duration<double, std::milli> busy{}, longest{};
 
-        flag =! flag;
+    void add(const std::chrono::duration<double, std::milli> time, const size_t calls) noexcept {
+        ++frames;
+        draw_calls += calls;
+        busy += time;
+        longest = std::max(longest, time);
     }
 
-
-    highlight(window, moves, highlights, AI_highlights, block, block_size);
-
-
-    // effectivly O(1)
-    for (auto x : range(8)) numbering(window, x, 7, block_size);
-    for (auto y : range(8)) numbering(window, 0, y, block_size);
-
-}
-
-
-static void winningText(sf::RenderWindow& window, const std::string_view t) {
-    sf::Text text{font};
-    text.setString(t.data());
-    text.setCharacterSize(64);
-    text.setOutlineThickness(2);
-
-    const sf::FloatRect textRect = text.getLocalBounds();
-    text.setOrigin({textRect.position.x + textRect.size.x / 2, textRect.position.x + textRect.size.y / 2});
-    const auto [width, height] = window.getSize();
-    text.setPosition({static_cast<float>(width / 2), static_cast<float>(height / 2)});
-
-
-    window.draw(text);
-}
+    double average() const noexcept { return frames ? busy.count() / static_cast<double>(frames) : 0; }
+};
 
 
 int main() {;
@@ -196,6 +111,8 @@ int main() {;
 
     window.setFramerateLimit(144);
 
+    BoardRenderer renderer{window.getSize()};
+
 
     BoardState board;
     // board = BoardState{"5B2/6b1/8/6b1/6y1/8/8/8"sv}; // TEST: move generation stops at promotion
@@ -210,12 +127,26 @@ int main() {;
     Move AI_move;
     Move AI_highlights;
 
+    // the AI thinks on another thread, the window keeps drawing meanwhile
+    AsyncSearch search;
+    search.setTablebase(std::make_shared<const Tablebase>(TABLEBASES_PATH));
+    auto next_hop = std::chrono::steady_clock::now();
+
 
     bool previous_turn{};
 
+    // what's on screen right now, and whether it has to be drawn again anyway (new window contents, stats changed)
+    FrameKey drawn;
+    bool force_redraw = true;
+
+    FrameStats shown_stats, logged_stats;
+    auto next_stats = std::chrono::steady_clock::now() + STATS_INTERVAL;
+    auto next_log   = std::chrono::steady_clock::now() + LOG_INTERVAL;
+
     while (window.isOpen()) {
         while (const std::optional event = window.pollEvent()) {
             if (event->is<sf::Event::Closed>() or sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Escape)) {
+                search.cancel();
                 window.close();
                 exit(0);
             }
@@ -223,42 +154,108 @@ int main() {;
             if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::R)) board = BoardState{};
 
             if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::F)) puts(board.fen().c_str());
-        }
 
-        window.clear();
+            if (const auto* key = event->getIf<sf::Event::KeyPressed>(); key and key->code == sf::Keyboard::Key::D) {
+                renderer.toggleStats();
+                force_redraw = true;
+            }
 
-        if (board.done()) {
-            background(window, moves, highlights, AI_highlights);
-            board.render(window);
-            std::tie(moves, highlights, AI_highlights) = board.update(window);
-            winningText(window, board.yellowCount() ? "Yellow wins!" : "Black wins!");
-            window.display();
-            continue;
+            // whatever was in the window may be gone
+            if (event->is<sf::Event::FocusGained>() or event->is<sf::Event::Resized>()) force_redraw = true;
         }
 
-        background(window, moves, highlights, AI_highlights);
 
-
-        if (previous_turn != board.turn) {
+        // nothing left to play, the window just stays up with the result. A ponder from the last turn would
+        // otherwise go on for its whole hour
+        if (board.done()) search.cancel();
+        else if (previous_turn != board.turn) {
             std::clog << "Board Score: " << (1 - board.turn) * -1 * board.evaluate() << '\n';
             previous_turn = board.turn; // skip one frame 
         }
         else if (board.blackTurn()) {
-            using std::chrono::operator""s;
+            const auto now = std::chrono::steady_clock::now();
+
+            if (board.AIInflight()) {
+                // keep play the current move
+                if (now >= next_hop) {
+                    board.play(AI_move);
+                    next_hop = now + HOP_DELAY;
+                }
+            }
+            else if (not search.searching(board)) search.start(board, AI_LIMITS); // generate a new move
+            else if (const auto move = search.poll(); move and *move) {
+                std::clog << "AI searched " << search.nodes() << " nodes, depth " << search.depth() << '\n';
 
-            if (board.AIInflight())
-                std::this_thread::sleep_for(.5s); // wait half a second between each move to make it clear whats going on
-            else
-                AI_move = board.bestMove(); // generate a new move
+                AI_move = *move;
+                board.play(AI_move);
+                next_hop = now + HOP_DELAY;
+            }
+        }
+        // think on the player's time too, if there's anything to think about
+        else if (not board.canMove()) search.cancel();
+        else if (not search.ponderingOn(board)) search.ponder(board);
+
+        // the player is yellow, and waits until the AI's last hop lands
+        std::tie(moves, highlights, AI_highlights) = board.update(window, board.yellowTurn() and not board.AIInflight());
+
+
+        const auto now = std::chrono::steady_clock::now();
+        ++shown_stats.loops;
+        ++logged_stats.loops;
+
+        if (now >= next_stats) {
+            std::ostringstream text;
+            text << std::fixed << std::setprecision(2) << shown_stats.average() << " ms/frame  "
+                 << shown_stats.frames << " frames/s  "
+                 << (shown_stats.frames ? shown_stats.draw_calls / shown_stats.frames : 0) << " draw calls";
+            renderer.setStats(text.str());
+
+            force_redraw = force_redraw or renderer.statsShown();
+            shown_stats = {};
+            next_stats = now + STATS_INTERVAL;
+        }
+
+        if (now >= next_log) {
+            std::clog << std::fixed << std::setprecision(2)
+                      << "frames: " << logged_stats.frames << " drawn in " << logged_stats.loops << " loops, "
+                      << logged_stats.average() << " ms average, " << logged_stats.longest.count() << " ms longest, "
+                      << logged_stats.draw_calls << " draw calls\n" << std::defaultfloat;
 
-            // keep play the current move
-            board.play(AI_move);
+            logged_stats = {};
+            next_log = now + LOG_INTERVAL;
         }
 
-        board.render(window);
-        std::tie(moves, highlights, AI_highlights) = board.update(window);
+
+        const bool blinking = highlights.empty() and std::ranges::any_of(moves, &Move::doesCapture);
+        const FrameKey key{
+            .hash = board.getHash(),
+            .moves = moves.size(),
+            .highlights = highlights.size(),
+            .AI_hops = AI_highlights.positions.size(),
+            .blink_on = blinking and (now.time_since_epoch() / BLINKING_TIME) % 2 == 0,
+            .dragging = board.isDragging(),
+            .mouse = board.isDragging() ? sf::Mouse::getPosition(window) : sf::Vector2i{},
+        };
+
+        if (not force_redraw and key == drawn) {
+            std::this_thread::sleep_for(IDLE_WAIT);
+            continue;
+        }
+
+        renderer.clear();
+        highlight(renderer, moves, highlights, AI_highlights, key.blink_on);
+        board.render(renderer, window);
+        if (board.done()) renderer.showMessage(board.yellowCount() ? "Yellow wins!" : "Black wins!");
+        renderer.draw(window);
+
+        // the CPU side only, display() waits on the frame limit
+        const std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - now;
+        shown_stats .add(time, renderer.draw_calls);
+        logged_stats.add(time, renderer.draw_calls);
 
         window.display();
+
+        drawn = key;
+        force_redraw = false;
     }
 }
-
@@ -0,0 +1,433 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <map>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "Board.hxx"
+
+
+// plays the engine against itself without a window, many games at once, to see whether a change actually helps
+//
+// usage: dama_match [--option=value ...]
+//
+//   --games=N           games to play, in pairs from the same opening with the colours swapped (default 200)
+//   --concurrency=N     games played at once (default all cores)
+//   --openings=FILE     one opening per line, a fen then y or b for the side to move (default the starting position)
+//   --random-plies=N    random moves played from the opening first, so games don't all repeat (default 4)
+//   --seed=N            for the random moves (default 1)
+//   --max-plies=N       draw after this many plies (default 300)
+//   --quiet-plies=N     draw after this many plies without a capture or a pawn move (default 80)
+//   --win-score=N       win once both engines agree one side is at least this much ahead... (default 1500)
+//   --win-plies=N       ...for this many plies in a row (default 8)
+//   --tablebases=DIR    both engines probe these, and games that get there are decided by them (default tablebases)
+//   --hash=MB           table size for each engine (default 16)
+//   --log=FILE          one line per game: colours, result, why, opening and final position
+//
+// engine options, --a-... for the first engine and --b-... for the second
+//
+//   --a-depth=N         (default 6)
+//   --a-time=MS         per move (default 1000)
+//   --a-threads=N       per search (default 1)
+//   --a-pawn=N          piece values, see Piece::value
+//   --a-shaikh=N
+//   --a-promotion=N,N,N,N,N,N,N,N   yellow's pawn bonus for each row from the top, black gets the mirror. See PROMOTION_DISTANCE
+
+
+struct Engine {
+    SearchLimits limits{.depth = 6, .time = std::chrono::seconds{1}};
+    EvalWeights weights;
+};
+
+struct MatchOptions {
+    std::array<Engine, 2> engines;
+
+    int games = 200;
+    int concurrency = int(std::max(1u, std::thread::hardware_concurrency()));
+    std::string openings_path;
+    int random_plies = 4;
+    unsigned seed = 1;
+    int max_plies = 300;
+    int quiet_plies = 80;
+    int win_score = 1500;
+    int win_plies = 8;
+    std::string tablebases_path = "tablebases";
+    size_t hash = 16;
+    std::string log_path;
+};
+
+struct Opening {
+    std::string fen;
+    bool yellow_starts = true;
+};
+
+
+enum class Outcome { YELLOW_WINS, BLACK_WINS, DRAW };
+
+struct GameResult {
+    Outcome outcome = Outcome::DRAW;
+    std::string_view reason;
+    int plies{};
+    std::string opening;
+    std::string final;
+};
+
+
+// per move, for one engine
+struct SearchStats {
+    size_t moves{};
+    size_t nodes{};
+    size_t depth{};
+    double seconds{};
+    double longest{};
+
+    void add(const Board& board, const double move_seconds) noexcept {
+        ++moves;
+        nodes   += board.nodes;
+        depth   += size_t(board.searched_depth);
+        seconds += move_seconds;
+        longest  = std::max(longest, move_seconds);
+    }
+
+    SearchStats& operator+=(const SearchStats& other) noexcept {
+        moves   += other.moves;
+        nodes   += other.nodes;
+        depth   += other.depth;
+        seconds += other.seconds;
+        longest  = std::max(longest, other.longest);
+        return *this;
+    }
+};
+
+
+// Board plus the list of moves, which the random opening moves need
+class MatchBoard : public Board {
+public:
+    using Board::Board;
+
+    const std::vector<Move>& moves() {
+        generateMoves();
+        return possible_moves;
+    }
+};
+
+
+static std::string fenWithTurn(const Board& board) { return board.fen() + (board.yellowTurn() ? " y" : " b"); }
+
+
+// the main loop of main.cc, minus the window. `engines` is yellow then black
+static GameResult playGame(
+    const Opening& opening, const std::array<const Engine*, 2> engines, const std::array<std::shared_ptr<TranspositionTable>, 2>& tables,
+    const std::shared_ptr<const Tablebase>& tablebase, const MatchOptions& options, std::mt19937_64& rng, std::array<SearchStats*, 2> stats
+) {
+    MatchBoard board{opening.fen, opening.yellow_starts};
+    board.setTablebase(tablebase);
+
+    for (int ply{}; ply < options.random_plies; ++ply) {
+        const auto& moves = board.moves();
+        if (moves.empty()) break;
+
+        const auto move = moves[std::uniform_int_distribution<size_t>{0, moves.size() - 1}(rng)];
+        board.makeMove(board.get(move.positions[0]), move);
+    }
+
+    GameResult result;
+    result.opening = fenWithTurn(board);
+
+    const auto win = [] (const bool yellow) { return yellow ? Outcome::YELLOW_WINS : Outcome::BLACK_WINS; };
+
+    int quiet{};
+    int yellow_ahead{}, black_ahead{}; // plies in a row both engines thought so
+    for (;; ++result.plies) {
+        if (const auto known = board.probeTablebase()) {
+            result.outcome = *known == 0 ? Outcome::DRAW : win(board.yellowTurn() == (*known > 0));
+            result.reason  = "tablebase";
+            break;
+        }
+
+        if (result.plies >= options.max_plies) { result.reason = "max plies";   break; }
+        if (quiet >= options.quiet_plies)      { result.reason = "quiet plies"; break; }
+
+
+        const auto side = board.yellowTurn() ? 0uz : 1uz;
+        board.setWeights(engines[side]->weights);
+        board.setTable(tables[side]);
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto move = board.bestMove(engines[side]->limits);
+        stats[side]->add(board, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+        if (not move) {
+            result.outcome = win(not board.yellowTurn());
+            result.reason  = "no moves";
+            break;
+        }
+
+        // a forced move isn't searched, so it says nothing either way
+        if (board.searched_depth) {
+            const auto yellow_score = board.yellowTurn() ? board.searched_score : -board.searched_score;
+            yellow_ahead = yellow_score >=  options.win_score ? yellow_ahead + 1 : 0;
+            black_ahead  = yellow_score <= -options.win_score ?  black_ahead + 1 : 0;
+
+            if (yellow_ahead >= options.win_plies or black_ahead >= options.win_plies) {
+                result.outcome = win(yellow_ahead >= options.win_plies);
+                result.reason  = "score";
+                break;
+            }
+        }
+
+        const auto piece = board.get(move.positions[0]);
+        quiet = move.doesCapture() or piece.isPawn() ? 0 : quiet + 1;
+
+        board.makeMove(piece, move);
+    }
+
+    result.final = fenWithTurn(board);
+    return result;
+}
+
+
+// Elo difference for a score fraction
+static double elo(const double score) {
+    const auto clamped = std::clamp(score, 1e-6, 1 - 1e-6);
+    return -400 * std::log10(1 / clamped - 1);
+}
+
+
+static std::vector<Opening> readOpenings(const std::string& path) {
+    if (path.empty()) return {{std::string{Board::STARTING_FEN}}};
+
+    std::vector<Opening> openings;
+    std::ifstream file{path};
+    for (std::string line; std::getline(file, line);) {
+        std::istringstream words{line};
+
+        Opening opening;
+        std::string turn;
+        if (not (words >> opening.fen) or opening.fen.starts_with('#')) continue;
+        if (words >> turn) opening.yellow_starts = turn != "b";
+
+        openings.push_back(std::move(opening));
+    }
+
+    return openings;
+}
+
+
+static bool parseOption(MatchOptions& options, const std::string_view arg) {
+    const auto equals = arg.find('=');
+    if (not arg.starts_with("--") or equals == std::string_view::npos) return false;
+
+    const auto key = arg.substr(2, equals - 2);
+    const std::string value{arg.substr(equals + 1)};
+    const auto number = [&value] { return std::atoi(value.c_str()); };
+
+    if (key.starts_with("a-") or key.starts_with("b-")) {
+        auto& engine = options.engines[key[0] == 'a' ? 0 : 1];
+        const auto engine_key = key.substr(2);
+
+        if      (engine_key == "depth")   engine.limits.depth   = std::clamp(number(), 1, MAX_SEARCH_DEPTH);
+        else if (engine_key == "time")    engine.limits.time    = std::chrono::milliseconds{number()};
+        else if (engine_key == "threads") engine.limits.threads = std::max(1, number());
+        else if (engine_key == "pawn")    engine.weights.pawn   = number();
+        else if (engine_key == "shaikh")  engine.weights.shaikh = number();
+        else if (engine_key == "promotion") {
+            std::vector<int> bonuses;
+            std::istringstream list{value};
+            for (std::string bonus; std::getline(list, bonus, ',');) bonuses.push_back(std::atoi(bonus.c_str()));
+            if (bonuses.size() != 8) return false;
+
+            for (const auto y : range(8uz)) {
+                engine.weights.promotion_distance[y].second    = bonuses[y];
+                engine.weights.promotion_distance[7 - y].first = bonuses[y];
+            }
+        }
+        else return false;
+
+        return true;
+    }
+
+    if      (key == "games")        options.games        = std::max(1, number());
+    else if (key == "concurrency")  options.concurrency  = std::max(1, number());
+    else if (key == "openings")     options.openings_path = value;
+    else if (key == "random-plies") options.random_plies = std::max(0, number());
+    else if (key == "seed")         options.seed         = unsigned(number());
+    else if (key == "max-plies")    options.max_plies    = number();
+    else if (key == "quiet-plies")  options.quiet_plies  = number();
+    else if (key == "win-score")    options.win_score    = number();
+    else if (key == "win-plies")    options.win_plies    = number();
+    else if (key == "tablebases")   options.tablebases_path = value;
+    else if (key == "hash")         options.hash         = size_t(std::max(1, number()));
+    else if (key == "log")          options.log_path     = value;
+    else return false;
+
+    return true;
+}
+
+
+static void printEngine(const char name, const Engine& engine) {
+    std::cout << "  " << name << ": depth " << engine.limits.depth << ", " << engine.limits.time.count() << "ms, "
+              << engine.limits.threads << " threads, pawn " << engine.weights.pawn << ", shaikh " << engine.weights.shaikh << ", promotion";
+
+    for (const auto& [_, bonus] : engine.weights.promotion_distance) std::cout << ' ' << bonus;
+    std::cout << '\n';
+}
+
+static void printStats(const char name, const SearchStats& stats) {
+    const auto moves = double(std::max(stats.moves, 1uz));
+
+    std::cout
+        << "  " << name
+        << std::setw(10) << stats.moves
+        << std::setw(10) << std::setprecision(2) << double(stats.depth) / moves
+        << std::setw(14) << std::setprecision(0) << double(stats.nodes) / moves
+        << std::setw(10) << std::setprecision(2) << stats.seconds / moves * 1000
+        << std::setw(12) << std::setprecision(2) << stats.longest * 1000
+        << std::setw(14) << std::setprecision(0) << (stats.seconds > 0 ? double(stats.nodes) / stats.seconds : 0)
+        << '\n';
+}
+
+
+int main(int argc, char** argv) {
+    MatchOptions options;
+    for (const auto i : range(1, argc)) {
+        if (not parseOption(options, argv[i])) {
+            std::cerr << "unknown option " << argv[i] << ", see the top of match.cc\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    const auto openings = readOpenings(options.openings_path);
+    if (openings.empty()) {
+        std::cerr << "no openings in " << options.openings_path << '\n';
+        return EXIT_FAILURE;
+    }
+
+    const auto tablebase = std::make_shared<const Tablebase>(options.tablebases_path);
+
+    std::ofstream log;
+    if (not options.log_path.empty()) log.open(options.log_path);
+
+
+    std::cout << options.games << " games, " << options.concurrency << " at a time, " << openings.size() << " openings";
+    if (tablebase->maxPieces()) std::cout << ", tablebases up to " << tablebase->maxPieces() << " pieces";
+    std::cout << '\n';
+
+    printEngine('A', options.engines[0]);
+    printEngine('B', options.engines[1]);
+
+
+    std::vector<GameResult> results(size_t(options.games));
+    std::array<SearchStats, 2> stats; // by engine
+    std::atomic<int> next_game{}, finished{};
+    std::mutex mutex;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::jthread> workers;
+    for (int worker{}; worker < options.concurrency; ++worker) {
+        workers.emplace_back([&] {
+            // every game starts with empty tables, so the order games happen to run in doesn't matter
+            const std::array tables = {std::make_shared<TranspositionTable>(options.hash), std::make_shared<TranspositionTable>(options.hash)};
+            std::array<SearchStats, 2> local_stats;
+
+            for (int game; (game = next_game++) < options.games;) {
+                // both games of a pair get the same opening, with A on the other side in the second one
+                const auto pair = game / 2;
+                const bool a_is_yellow = game % 2 == 0;
+
+                std::mt19937_64 rng{options.seed + unsigned(pair)};
+                for (const auto& table : tables) table->clear();
+
+                const auto& [a, b] = options.engines;
+                const auto engines = a_is_yellow ? std::array<const Engine*, 2>{&a, &b} : std::array<const Engine*, 2>{&b, &a};
+
+                const std::array<std::shared_ptr<TranspositionTable>, 2> colour_tables = a_is_yellow
+                    ? tables : std::array{tables[1], tables[0]};
+
+                const std::array<SearchStats*, 2> colour_stats = a_is_yellow
+                    ? std::array{&local_stats[0], &local_stats[1]}
+                    : std::array{&local_stats[1], &local_stats[0]};
+
+                auto& result = results[size_t(game)];
+                result = playGame(openings[size_t(pair) % openings.size()], engines, colour_tables, tablebase, options, rng, colour_stats);
+
+                const auto done = ++finished;
+
+                const std::lock_guard lock{mutex};
+                if (log.is_open()) {
+                    log << "game " << game << ": A " << (a_is_yellow ? "yellow" : "black") << ", "
+                        << (result.outcome == Outcome::YELLOW_WINS ? "yellow wins" : result.outcome == Outcome::BLACK_WINS ? "black wins" : "draw")
+                        << " (" << result.reason << ") after " << result.plies << " plies, opening " << result.opening
+                        << ", final " << result.final << '\n';
+                }
+
+                if (done % std::max(1, options.games / 20) == 0) std::cout << "  " << done << '/' << options.games << " games\n" << std::flush;
+            }
+
+            const std::lock_guard lock{mutex};
+            for (const auto i : range(2uz)) stats[i] += local_stats[i];
+        });
+    }
+    workers.clear(); // joins
+
+    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+
+    // from A's side
+    int wins{}, draws{}, losses{};
+    size_t plies{};
+    std::map<std::string_view, int> reasons;
+    for (auto&& [game, result] : enumerate(results)) {
+        const bool a_is_yellow = game % 2 == 0;
+
+        if (result.outcome == Outcome::DRAW) ++draws;
+        else if ((result.outcome == Outcome::YELLOW_WINS) == a_is_yellow) ++wins;
+        else ++losses;
+
+        plies += size_t(result.plies);
+        ++reasons[result.reason];
+    }
+
+    const auto games = double(options.games);
+    const auto score = (wins + 0.5 * draws) / games;
+
+    // 95% interval on the score per game, turned into Elo
+    const auto variance = (wins * std::pow(1 - score, 2) + draws * std::pow(0.5 - score, 2) + losses * std::pow(score, 2)) / games;
+    const auto margin = 1.96 * std::sqrt(variance / games);
+
+    std::cout << std::fixed << std::setprecision(2)
+              << '\n' << options.games << " games in " << seconds << "s, " << games / seconds << " games/s, "
+              << std::setprecision(1) << double(plies) / games << " plies per game\n";
+
+    std::cout << "  A: +" << wins << " =" << draws << " -" << losses
+              << "  score " << score * 100 << "%"
+              << "  Elo " << std::showpos << elo(score) << std::noshowpos
+              << " +/- " << (elo(std::min(score + margin, 1.0)) - elo(std::max(score - margin, 0.0))) / 2 << " (95%)\n";
+
+    std::cout << "  ended by";
+    for (const char* separator = " "; const auto& [reason, count] : reasons) {
+        std::cout << separator << reason << ' ' << count;
+        separator = ", ";
+    }
+    std::cout << '\n';
+
+    std::cout << "\n  engine     moves    depth     nodes/move   ms/move  longest ms       nodes/s\n";
+    printStats('A', stats[0]);
+    printStats('B', stats[1]);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,296 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <filesystem>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <cstdlib>
+
+#include "Board.hxx"
+
+
+// builds the endgame tables Board probes, every material up to some number of pieces
+//
+// usage: dama_tbgen [max pieces = 3] [directory = tablebases]
+//
+// Retrograde: positions that are lost right away come first, then whatever wins against those in one ply, whatever
+// only loses to those, and so on until nothing changes. What's left is a draw. A capture or promotion lands in a
+// smaller table, which is why those get built first. Every finished table is checked against its moves before it's
+// written, and the run fails if any position is off
+
+
+// a position out of a table. Pieces are put straight into the bitboards, the generator goes through millions of these
+class TablebaseBoard : public Board {
+public:
+    TablebaseBoard() : Board{std::string_view{"8/8/8/8/8/8/8/8"}} {}
+
+    // false if it can't happen: two pieces on one square, or a pawn sitting where it would've promoted
+    bool place(const Material material, const size_t index) noexcept {
+        const auto position = Tablebase::position(material, index);
+
+        yellow_bits = position.yellow;
+        black_bits  = position.black;
+        shaikh_bits = position.shaikhs;
+        turn = position.yellow_turn ? YELLOW_TURN : BLACK_TURN;
+        recomputeIncremental();
+
+        return popCount(yellow_bits | black_bits) == material.pieces()
+            and popCount(shaikh_bits) == material.yellow_shaikhs + material.black_shaikhs
+            and not (yellow_bits & ~shaikh_bits & (YELLOW_FORWARD == NORTH ? ROW_0 : ROW_7))
+            and not ( black_bits & ~shaikh_bits & (YELLOW_FORWARD == NORTH ? ROW_7 : ROW_0));
+    }
+
+    Material material() const noexcept { return Material::of(yellow_bits, black_bits, shaikh_bits); }
+
+    size_t index(const Material material) const noexcept { return Tablebase::index(material, yellow_bits, black_bits, shaikh_bits, yellowTurn()); }
+
+    bool sideToMoveGone() const noexcept { return not ownBits(); }
+
+    std::optional<std::uint8_t> probeSmaller(const Tablebase& smaller) const noexcept { return smaller.value(yellow_bits, black_bits, shaikh_bits, yellowTurn()); }
+
+    Bitboard shaikhs() const noexcept { return shaikh_bits; }
+};
+
+
+// never a real value, tablebaseValue() tops out before this
+constexpr std::uint8_t IMPOSSIBLE = 0xFF;
+constexpr int MAX_PLIES = IMPOSSIBLE - 2;
+
+
+// what the child `board` was just moved to is worth, for its side to move, and whether it's in a smaller table. A
+// conversion counts as one ply however long the smaller table takes after it, but keeps who wins: 0 plies if the side
+// to move there loses, 1 if it wins. `values` is the table being built, read while other threads may write it
+static std::pair<std::uint8_t, bool> childValue(const TablebaseBoard& board, const Material material, std::vector<std::uint8_t>& values, const Tablebase& smaller) {
+    if (board.sideToMoveGone()) return {tablebaseValue(0), true};
+
+    if (board.material() == material) return {std::atomic_ref{values[board.index(material)]}.load(std::memory_order_relaxed), false};
+
+    const auto child = board.probeSmaller(smaller).value_or(0);
+    if (not child) return {0, true};
+    return {tablebaseValue(tablebaseWin(child) ? 1 : 0), true};
+}
+
+
+// what `board` is worth `plies` plies into the table, if its children are known well enough by now. Only children
+// of this table known from before this pass count
+static std::uint8_t resolve(TablebaseBoard& board, std::vector<CompactMove>& moves, const Material material, std::vector<std::uint8_t>& values, const Tablebase& smaller, const int plies) {
+    moves.clear();
+    board.generateMoves(moves);
+
+    // no moves is a loss, and the only thing known before any plies go by
+    if (moves.empty()) return tablebaseValue(0);
+    if (plies == 0) return 0;
+
+    bool all_lost = true;
+    int longest{};
+    for (const auto move : moves) {
+        const auto piece = board.get(positionOf(move.from));
+        const auto captured_shaikhs = move.captures & board.shaikhs();
+
+        board.makeMove(piece, move);
+        const auto [child, converted] = childValue(board, material, values, smaller);
+        board.unMakeMove(piece, move, captured_shaikhs);
+
+        const auto child_plies = tablebasePlies(child);
+        if (not child or (not converted and child_plies >= plies)) {
+            all_lost = false;
+            continue;
+        }
+
+        // children known from before are plies - 1 at most, so the first lost one is the fastest win there is
+        if (not tablebaseWin(child)) return tablebaseValue(child_plies + 1);
+
+        longest = std::max(longest, child_plies);
+    }
+
+    return all_lost ? tablebaseValue(longest + 1) : 0;
+}
+
+
+// what `board` should be worth going by its children in the finished table: the fastest win, else the slowest loss.
+// Worked out from the raw values on its own rather than through childValue(), so it can catch that being wrong too
+static std::uint8_t expected(TablebaseBoard& board, std::vector<CompactMove>& moves, const Material material, const std::vector<std::uint8_t>& values, const Tablebase& smaller) {
+    moves.clear();
+    board.generateMoves(moves);
+
+    if (moves.empty()) return tablebaseValue(0);
+
+    bool all_lost = true;
+    int fastest_win = MAX_PLIES + 1, longest{};
+    for (const auto move : moves) {
+        const auto piece = board.get(positionOf(move.from));
+        const auto captured_shaikhs = move.captures & board.shaikhs();
+
+        board.makeMove(piece, move);
+        const bool gone = board.sideToMoveGone(), converted = gone or board.material() != material;
+        const std::uint8_t child = gone ? tablebaseValue(0) : converted ? board.probeSmaller(smaller).value_or(0) : values[board.index(material)];
+        board.unMakeMove(piece, move, captured_shaikhs);
+
+        // after a conversion only who wins matters, it's a ply either way
+        if (not child) all_lost = false;
+        else if (not tablebaseWin(child)) fastest_win = std::min(fastest_win, converted ? 1 : tablebasePlies(child) + 1);
+        else longest = std::max(longest, converted ? 1 : tablebasePlies(child));
+    }
+
+    if (fastest_win <= MAX_PLIES) return tablebaseValue(fastest_win);
+    return all_lost ? tablebaseValue(longest + 1) : 0;
+}
+
+
+static std::vector<std::uint8_t> generate(const Material material, const Tablebase& smaller) {
+    const auto size = Tablebase::size(material);
+    std::vector<std::uint8_t> values(size);
+
+    const auto thread_count = std::max(1u, std::thread::hardware_concurrency());
+
+    // the most plies any value found so far has. Some come out longer than the pass that finds them (a loss with
+    // only conversions for moves is 2 plies on pass 1), and those are only seen by the passes after their plies
+    int deepest{};
+
+    bool settled = false;
+    for (int plies = 0; plies <= MAX_PLIES and not settled; ++plies) {
+        std::atomic<size_t> resolved{};
+        std::vector<int> deepest_by_thread(thread_count);
+
+        // every thread gets every thread_count-th position, so they all get about the same share of the hard ones
+        std::vector<std::jthread> threads;
+        for (const auto t : range(thread_count)) {
+            threads.emplace_back([&, t] {
+                TablebaseBoard board;
+                std::vector<CompactMove> moves;
+                size_t count{};
+
+                for (size_t index = t; index < size; index += thread_count) {
+                    const std::atomic_ref value{values[index]};
+                    if (value.load(std::memory_order_relaxed)) continue;
+
+                    if (not board.place(material, index)) {
+                        value.store(IMPOSSIBLE, std::memory_order_relaxed);
+                        continue;
+                    }
+
+                    if (const auto found = resolve(board, moves, material, values, smaller, plies)) {
+                        value.store(found, std::memory_order_relaxed);
+                        deepest_by_thread[t] = std::max(deepest_by_thread[t], tablebasePlies(found));
+                        ++count;
+                    }
+                }
+
+                resolved += count;
+            });
+        }
+        threads.clear(); // joins
+
+        deepest = std::max(deepest, std::ranges::max(deepest_by_thread));
+
+        // nothing new, and nothing found earlier still waiting to be seen, means nothing new ever
+        settled = resolved == 0 and deepest < plies;
+    }
+
+    if (not settled) std::cerr << material.name() << " goes on for more than " << MAX_PLIES << " plies, anything longer is left as a draw\n";
+
+    std::ranges::replace(values, IMPOSSIBLE, 0);
+    return values;
+}
+
+
+// every position checked against its children once the table is done. Returns how many are off, and prints the first few
+static size_t verify(const Material material, const std::vector<std::uint8_t>& values, const Tablebase& smaller) {
+    const auto thread_count = std::max(1u, std::thread::hardware_concurrency());
+    std::atomic<size_t> mismatches{};
+
+    std::vector<std::jthread> threads;
+    for (const auto t : range(thread_count)) {
+        threads.emplace_back([&, t] {
+            TablebaseBoard board;
+            std::vector<CompactMove> moves;
+
+            for (size_t index = t; index < values.size(); index += thread_count) {
+                if (not board.place(material, index)) continue;
+
+                const auto value = expected(board, moves, material, values, smaller);
+                if (value == values[index]) continue;
+
+                // a line at a time, threads can interleave whole lines but not inside one
+                if (mismatches++ < 10) std::cerr << (material.name() + ": " + board.fen() + (board.yellowTurn() ? " y" : " b")
+                    + " is " + std::to_string(values[index]) + ", its moves say " + std::to_string(value) + '\n');
+            }
+        });
+    }
+    threads.clear(); // joins
+
+    return mismatches;
+}
+
+
+static bool write(const std::filesystem::path& path, const Material material, const std::vector<std::uint8_t>& values) {
+    Tablebase::Header header;
+    header.material = {
+        static_cast<std::uint8_t>(material.yellow_pawns), static_cast<std::uint8_t>(material.yellow_shaikhs),
+        static_cast<std::uint8_t>(material.black_pawns ), static_cast<std::uint8_t>(material.black_shaikhs ),
+    };
+
+    std::ofstream file{path, std::ios::binary};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(values.data()), std::streamsize(values.size()));
+    return bool(file);
+}
+
+
+int main(int argc, char** argv) {
+    const int max_pieces = std::clamp(argc > 1 ? std::atoi(argv[1]) : 3, 2, TABLEBASE_MAX_PIECES);
+    const std::filesystem::path directory = argc > 2 ? argv[2] : "tablebases";
+
+    std::filesystem::create_directories(directory);
+
+    // every table built so far, mapped back in from disk like the search would
+    Tablebase tables;
+
+    // captures go to fewer pieces and promotions to fewer pawns, so that's the order
+    for (const auto pieces : range(2, max_pieces + 1)) {
+        for (const auto pawns : range(0, pieces + 1)) {
+            for (const auto yellow_pawns : range(0, pawns + 1)) {
+                for (const auto yellow_shaikhs : range(0, pieces - pawns + 1)) {
+                    const Material material{yellow_pawns, yellow_shaikhs, pawns - yellow_pawns, pieces - pawns - yellow_shaikhs};
+                    if (material.yellow_pawns + material.yellow_shaikhs == 0 or material.black_pawns + material.black_shaikhs == 0) continue;
+
+                    const auto path = directory / (material.name() + std::string{Tablebase::EXTENSION});
+
+                    const auto start = std::chrono::steady_clock::now();
+                    const auto values = generate(material, tables);
+                    const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                    // a wrong value here would end up in every bigger table built on top of this one
+                    if (const auto mismatches = verify(material, values, tables)) {
+                        std::cerr << material.name() << " has " << mismatches << " positions that don't match their moves, not writing it\n";
+                        return EXIT_FAILURE;
+                    }
+
+                    if (not write(path, material, values) or not tables.load(path)) {
+                        std::cerr << "couldn't write " << path << '\n';
+                        return EXIT_FAILURE;
+                    }
+
+                    const auto wins   = std::ranges::count_if(values, [] (const auto value) { return tablebaseWin(value); });
+                    const auto losses = std::ranges::count_if(values, [] (const auto value) { return value and not tablebaseWin(value); });
+                    const auto longest = std::ranges::max(values | std::views::transform([] (const auto value) { return value ? tablebasePlies(value) : 0; }));
+
+                    std::cout
+                        << std::left << std::setw(10) << material.name() << std::right
+                        << std::setw(12) << values.size() << " positions "
+                        << std::setw(10) << wins << " wins "
+                        << std::setw(10) << losses << " losses "
+                        << std::setw(4) << longest << " plies longest "
+                        << std::fixed << std::setprecision(2) << seconds << "s\n";
+                }
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}